@@ -257,18 +257,24 @@ public:
 class EnemySpawner : public Behaviour
 {
     float frequence = 5.f;
-    float timer = 0.f;
 
-    void Update(float dt) override
+    void OnEnable() override
+    {
+        StopAllCoroutines();    // OnEnable puede llegar mas de una vez
+        StartCoroutine(SpawnLoop());
+    }
+
+    Coroutine SpawnLoop()
     {
-        if (timer < frequence)
+        while (true)
         {
-            timer += dt;
-            return;
+            co_await WaitForSeconds(frequence);
+            SpawnEnemy();
         }
+    }
 
-        timer = 0;
-
+    void SpawnEnemy()
+    {
         auto* texEnemy = Assets->GetTextureByKey("enemy");
         GameObject* enemy = CreateSpriteObject(
             gameObject->scene, "Enemy", texEnemy,
@@ -384,65 +390,30 @@ void InitGame(Engine& engine)
         player->AddComponent<RigidBody2D>();
         player->GetComponent<Collider2D>()->shape = Collider2D::Shape::Circle;
         player->GetComponent<Collider2D>()->radius = player->GetComponent<Collider2D>()->size->x / 2.5f;
+        player->simulationLodPinned = true;
 
 
-        // 5) Paredes (arena simple)
+        // 5) Paredes (arena simple): un Tilemap de 43x41 con solo el borde relleno.
+        // Su colision son 4 rectangulos fusionados (mas cortes de franja), no una caja por tile.
         auto* texWall = assets->GetTextureByKey("wall");
-        // Suponiendo tamao 1x1 world cada tile, crea un rectngulo de 10x10
-        for (int x = -20; x <= 20; ++x) {
-            // top
-            auto* wallTop = CreateSpriteObject(scn, "WallTop", texWall,
-                Vec3{ (float)x, -20.f, 0.f },
-                Vec2{ 1.f, 1.f }, false, 1u << 1, 0xFFFFFFFFu, false);
-
-            // bottom
-            auto* wallBot = CreateSpriteObject(scn, "WallBot", texWall,
-                Vec3{ (float)x, 20.f, 0.f },
-                Vec2{ 1.f, 1.f }, false, 1u << 1, 0xFFFFFFFFu, false);
-        }
-        for (int y = -20; y <= 20; ++y) {
-            // left
-            auto* wallLeft = CreateSpriteObject(scn, "WallLeft", texWall,
-                Vec3{ -21.f, (float)y, 0.f },
-                Vec2{ 1.f, 1.f }, false, 1u << 1, 0xFFFFFFFFu, false);
-
-            // right
-            auto* wallRight = CreateSpriteObject(scn, "WallRight", texWall,
-                Vec3{ 21.f, (float)y, 0.f },
-                Vec2{ 1.f, 1.f }, false, 1u << 1, 0xFFFFFFFFu, false);
-        }
 
-        float ppu = texWall->PixelsPerUnit();
-        float wUnits = texWall->Width() / ppu;
-        float hUnits = texWall->Height() / ppu;
-        Vec2 scaleHWalls{ 41.f / wUnits, 1.f / hUnits };
-        Vec2 scaleVWalls{ 1.f / wUnits, 39.f / hUnits };
-        Vec2 sizeHWalls{ 1.f * wUnits, 1.f * hUnits };
-        Vec2 sizeVWalls{ 1.f * wUnits, 1.f * hUnits };
-
-        auto * wallUpCol = scn->CreateObject("WallUpCollision");
-        wallUpCol->transform->position = Vec3(0, -20, 0.f);
-        wallUpCol->transform->scale = scaleHWalls;
-        wallUpCol->AddComponent<Collider2D>()->size = sizeHWalls;
-        wallUpCol->tag = "wall";
-
-        auto* wallDownCol = scn->CreateObject("WallDownCollision");
-        wallDownCol->transform->position = Vec3(0, 20, 0.f);
-        wallDownCol->transform->scale = scaleHWalls;
-        wallDownCol->AddComponent<Collider2D>()->size = sizeHWalls;
-        wallDownCol->tag = "wall";
-
-        auto* wallLeftCol = scn->CreateObject("WallLeftCollision");
-        wallLeftCol->transform->position = Vec3(-21, 0, 0.f);
-        wallLeftCol->transform->scale = scaleVWalls;
-        wallLeftCol->AddComponent<Collider2D>()->size = sizeVWalls;
-        wallLeftCol->tag = "wall";
-
-        auto* wallRightCol = scn->CreateObject("WallRightCollision");
-        wallRightCol->transform->position = Vec3(21, 0, 0.f);
-        wallRightCol->transform->scale = scaleVWalls;
-        wallRightCol->AddComponent<Collider2D>()->size = sizeVWalls;
-        wallRightCol->tag = "wall";
+        // Paredes en su propia capa: las monedas (mask = capa 0) ni las consultan
+        constexpr LayerBits kWallLayer = 1u << 1;
+
+        auto* walls = scn->CreateObject("Walls");
+        walls->transform->position = Vec3(-21.5f, -20.5f, 0.f);   // tile (0,0) centrada en (-21, -20)
+        walls->tag = "wall";
+        walls->simulationLodPinned = true;     // su origen es una esquina: se mediria mal
+
+        auto* map = walls->AddComponent<Tilemap>();
+        map->atlas = texWall;
+        map->tileSize = Vec2{ 1.f, 1.f };
+        map->layer = kWallLayer;
+        map->Resize(43, 41);
+        map->Fill(0, 0, 43, 1, 0);      // arriba
+        map->Fill(0, 40, 43, 1, 0);     // abajo
+        map->Fill(0, 1, 1, 39, 0);      // izquierda
+        map->Fill(42, 1, 1, 39, 0);     // derecha
 
         coinPrefab = [](GameObject& go, Scene&)
             {
@@ -474,6 +445,7 @@ void InitGame(Engine& engine)
         GameObject* hud = scn->CreateObject("HUD and spawner");
         hud->AddComponent<HUDController>();
         hud->AddComponent<EnemySpawner>();
+        hud->simulationLodPinned = true;
 
         // 9) Configurar cmara inicial (opcional)
         Camera2D* cam = scn->camera;     // Scene tiene un Camera2D interno 
@@ -481,6 +453,10 @@ void InitGame(Engine& engine)
             cam->center = Vec2{ 0.f, 0.f };
             cam->viewBase = Vec2{ 20.f, 11.25f }; // 16:9 world size, por ejemplo
         }
+
+        // Los enemigos fuera de pantalla (a mas de 2 unidades) se actualizan uno de
+        // cada 4 frames / pasos; sin congelar, que tienen que seguir viniendo
+        scn->EnableSimulationLod(2.f, 4);
     });;
 
     scenes->SetActive("level1");
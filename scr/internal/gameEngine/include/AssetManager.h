@@ -12,6 +12,7 @@ class AssetManager final : public Singleton<AssetManager>
 {
 	friend class Singleton<AssetManager>;
 	friend class Engine;
+	friend class SceneSnapshot;
 
 private:
 	// caches por ruta (o por clave lgica)
@@ -35,6 +36,9 @@ private:
 
 	Font* GetEngineDefaultFont(bool bold) noexcept;
 
+	// Busqueda inversa (clave con la que se cacheo la textura). O(n), solo para guardar escenas.
+	std::string FindTextureKey(const Texture* tex) const noexcept;
+
 public:
 	// TEXTURAS
 	Texture* LoadTexture(const std::string& path, float pixelsPerUnit = 100.f) noexcept;
@@ -531,6 +531,34 @@ struct TRect
         return !(Right() < r.Left() || r.Right() < Left() || Bottom() < r.Top() || r.Bottom() < Top());
     }
 
+    // Segmento origin + dir * t, t en [0, maxT], contra el rect (slabs)
+    constexpr bool IntersectsRay(TVec2<T> origin, TVec2<T> dir, T maxT) const noexcept
+    {
+        T tMin = T{ 0 }, tMax = maxT;
+
+        const T o[2] = { origin.x, origin.y };
+        const T d[2] = { dir.x, dir.y };
+        const T lo[2] = { Left(), Top() };
+        const T hi[2] = { Right(), Bottom() };
+
+        for (int k = 0; k < 2; ++k)
+        {
+            if (d[k] == T{ 0 })
+            {
+                if (o[k] < lo[k] || o[k] > hi[k]) return false;
+                continue;
+            }
+
+            T t1 = (lo[k] - o[k]) / d[k];
+            T t2 = (hi[k] - o[k]) / d[k];
+            if (t1 > t2) std::swap(t1, t2);
+            tMin = std::max(tMin, t1);
+            tMax = std::min(tMax, t2);
+            if (tMin > tMax) return false;
+        }
+        return true;
+    }
+
     constexpr TRect Translated(TVec2<T> d) const noexcept { return { x + d.x, y + d.y, w, h }; }
 
     constexpr TRect Inset(T dx, T dy) const noexcept { return { x + dx, y + dy, w - T{2} *dx, h - T{2} *dy }; }
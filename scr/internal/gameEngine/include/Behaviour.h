@@ -1,10 +1,13 @@
 #pragma once
 
 #include <memory>
+#include <vector>
+#include <cstdint>
 #include <type_traits>
 
 #include "Component.h"
 #include "Property.h"
+#include "Coroutine.h"
 
 class Transform;
 class Scene;
@@ -14,6 +17,8 @@ class Behaviour : public Component
 {
     friend class GameObject;
     friend class Component;
+    friend class SceneSnapshot;
+    friend class CoroutineScheduler;
 
 private:
     bool IsEnabled() const noexcept { return mEnabled; }
@@ -34,6 +39,7 @@ private:
         else
         {
             OnDisable();
+            StopAllCoroutines();
         }
     }
 
@@ -52,6 +58,9 @@ private:
         }
     }
 
+    // Corrutinas lanzadas por este Behaviour (lista intrusiva del CoroutineScheduler)
+    CoroutineNode* mCoroutines = nullptr;
+
 protected:
     bool mEnabled = true;
 
@@ -69,8 +78,17 @@ protected:
     virtual void OnTriggerStay(const CollisionInfo2D&) {}
     virtual void OnTriggerExit(const CollisionInfo2D&) {}
 
+    // Snapshot binario (SceneSnapshot): datos propios del script.
+    // Solo se llaman para tipos registrados con SceneSnapshot::RegisterBehaviour<T>().
+    virtual void OnSnapshotSave(std::vector<uint8_t>&) const {}
+    virtual void OnSnapshotLoad(const uint8_t*, size_t) {}
+
+    // Corrutinas (ver Coroutine.h). Se paran solas en OnDisable / OnDestroy.
+    void StartCoroutine(Coroutine co) noexcept;
+    void StopAllCoroutines() noexcept;
+
 public:
-    virtual ~Behaviour() = default;
+    virtual ~Behaviour();
 
     using EnabledProp = Property<Behaviour, bool,
         &Behaviour::IsEnabled,
@@ -14,10 +14,18 @@ class Collider2D : public Behaviour
 {
 	friend class CollisionManager;
 	friend class PhysicsManager;
+	friend class SceneSnapshot;
 
 public:
     enum class Shape : uint8_t { Box, Circle };
 
+    // Clase de movimiento para el broadphase:
+    // - Auto: segun el RigidBody2D asociado (sin cuerpo = Kinematic)
+    // - Static: no se mueve nunca; se hornea en el BVH estatico y no se prueba
+    //   contra otros Static. Si se mueve a mano, reasignar bodyClass para re-hornear.
+    // - Kinematic / Dynamic: van al arbol dinamico y se consultan cada substep
+    enum class BodyClass : uint8_t { Auto, Static, Kinematic, Dynamic };
+
 private:
     friend class CollisionManager;
 	friend class GameObject;
@@ -27,11 +35,17 @@ private:
     bool       isTrigger_ = false;
     LayerBits  layer_ = 1u << 0;
     LayerBits  mask_ = 0xFFFFFFFFu;
+    BodyClass  bodyClass_ = BodyClass::Auto;
 
     bool drawCollider_ = false;
     Color drawColor_ = { 0, 255, 0, 100 };
     bool CustomGizmoColor = false;
 
+    // Posicion en la lista densa de colliders no estaticos del CollisionManager
+    int32_t broadRank_ = -1;
+    // Claves de los pares de la tabla del CollisionManager en que aparece este collider
+    std::vector<uint64_t> pairKeys_;
+
     // --- Geometra en ESPACIO LOCAL (unidades de mundo ANTES de escala/rotacin) ---
     // Para Box: sizeLocal = {w, h}. Para Circle, usar radiusLocal.
     Vec2      sizeLocal_{ 1.f, 1.f };
@@ -45,13 +59,14 @@ private:
     bool       inheritRotation_ = true;
     float      localAngleOffsetDeg_ = 0.f;
 
-    void SetLayer(LayerBits l) noexcept { layer_ = l; }
-    void SetMask(LayerBits m) noexcept { mask_ = m; }
+    void SetLayer(LayerBits l) noexcept;
+    void SetMask(LayerBits m) noexcept;
     void SetOffsetLocal(Vec2 off) noexcept { offsetLocal_ = off; }
 	void SetInheritRotation(bool inherit) noexcept { inheritRotation_ = inherit; }
 	void SetLocalAngleOffsetDeg(float angleDeg) noexcept { localAngleOffsetDeg_ = angleDeg; }
-	void SetIsTrigger(bool trigger) noexcept { isTrigger_ = trigger; }
+	void SetIsTrigger(bool trigger) noexcept;
 	void SetShape(Shape s) noexcept { shape_ = s; }
+    void SetBodyClass(BodyClass c) noexcept;
 	void SetRadiusLocal(float r) noexcept { radiusLocal_ = r; }
 	void SetSizeLocal(Vec2 s) noexcept { sizeLocal_ = s; }
     void SetDrawCollider(bool active) noexcept { drawCollider_ = active; }
@@ -64,6 +79,7 @@ private:
     bool      GetInheritRotation() const noexcept { return inheritRotation_; }
     float     GetLocalAngleOffsetDeg() const noexcept { return localAngleOffsetDeg_; }
     Shape     GetShape() const noexcept { return shape_; }
+    BodyClass GetBodyClass() const noexcept { return bodyClass_; }
     float     GetRadiusLocal() const noexcept { return radiusLocal_; }
     Vec2     GetSizeLocal() const noexcept { return sizeLocal_; }
     bool      GetDrawCollider() const noexcept { return drawCollider_; }
@@ -71,6 +87,9 @@ private:
 
     RigidBody2D* GetAttachedBody() const noexcept;
 
+    // bodyClass con Auto ya resuelto (nunca devuelve Auto)
+    BodyClass ResolveBodyClass() const noexcept;
+
 protected:
     // Ciclo (sin lgica)
     void Awake() override;        // registrar collider
@@ -98,6 +117,18 @@ protected:
     // AABB de la forma en mundo (til para broadphase)
     Rect          WorldAABB() const noexcept;
 
+    // Todo lo anterior de una vez (un acceso al Transform, un sin/cos): cache del CollisionManager
+    struct WorldShape {
+        Vec2 center;
+        Vec2 half;        // Box
+        Vec2 rot;         // Box: (cos, sin) del angulo final
+        float radius;     // Circle
+        Rect aabb;
+    };
+    WorldShape    ComputeWorldShape() const noexcept;
+    // Igual, con la pose del Transform dada (PhysicsManager la adelanta dentro de Step)
+    WorldShape    ComputeWorldShape(const Vec3& wpos, const Vec2& wsc, float rotZ) const noexcept;
+
     //std::unique_ptr<Component> Clone(GameObject* newOwner) const override;
 
 public:
@@ -114,6 +145,11 @@ public:
         &Collider2D::SetIsTrigger>;
     IsTriggerProp isTrigger{ this };
 
+    using BodyClassProp = Property<Collider2D, BodyClass,
+        &Collider2D::GetBodyClass,
+        &Collider2D::SetBodyClass>;
+    BodyClassProp bodyClass{ this };
+
     using LayerProp = Property<Collider2D, LayerBits,
         &Collider2D::GetLayer,
 		&Collider2D::SetLayer>;
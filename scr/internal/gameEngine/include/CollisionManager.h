@@ -1,52 +1,143 @@
 #pragma once
 
 #include <unordered_map>
-#include <unordered_set>
+#include <vector>
+#include <bit>
 
 #include "Singleton.h"
 #include "GameObject.h"
 #include "Collider2D.h"
+#include "DynamicAABBTree.h"
+#include "StaticBVH.h"
+#include "PairTable.h"
+#include "NarrowphaseBatch.h"
 #include "SceneManager.h"
 #include "Engine.h"
 
+// Punto de un manifold. id identifica las features (caras/vertices) que lo
+// generan: se mantiene entre pasos mientras el contacto sea el mismo y sirve
+// de clave para el warm starting del solver.
+struct ManifoldPoint {
+    Vec2 point{ 0.f, 0.f };
+    float penetration = 0.f;
+    uint32_t id = 0;
+};
+
+struct ContactManifold {
+    static constexpr uint32_t kMaxPoints = 2;
+
+    ManifoldPoint points[kMaxPoints]{};
+    uint32_t count = 0;
+
+    inline const ManifoldPoint* begin() const noexcept { return points; }
+    inline const ManifoldPoint* end() const noexcept { return points + count; }
+};
+
 struct NarrowContact {
     GameObject* a = nullptr;
     GameObject* b = nullptr;
     Collider2D* colA = nullptr;
     Collider2D* colB = nullptr;
+    RigidBody2D* bodyA = nullptr;   // cuerpo de cada lado (nullptr si no tiene)
+    RigidBody2D* bodyB = nullptr;
+    Vec2 centerA = { 0.f, 0.f };    // centro en mundo de cada collider (de la cache del substep)
+    Vec2 centerB = { 0.f, 0.f };
     bool isTriggerPair = false;
-    ContactPoint contact;
+    ContactPoint contact;           // resumen: punto medio, normal A->B y penetracion maxima
+    ContactManifold manifold;       // puntos para el solver (vacio en triggers)
+};
+
+// Resultado de un raycast / shape cast
+struct RaycastHit2D
+{
+    Collider2D* collider = nullptr;
+    GameObject* gameObject = nullptr;
+    Vec2 point = { 0.f, 0.f };      // punto de impacto en mundo
+    Vec2 normal = { 0.f, 0.f };     // normal de la superficie golpeada (hacia quien consulta)
+    float distance = 0.f;           // recorrido hasta el impacto (0 = ya solapaba al empezar)
+};
+
+// Filtro comun de las consultas
+struct QueryFilter2D
+{
+    LayerBits mask = 0xFFFFFFFFu;   // solo colliders con (layer & mask) != 0
+    bool hitTriggers = true;
 };
 
 // Forward declarations
 class PhysicsManager;
+class Scene;
 
 class CollisionManager : public Singleton<CollisionManager>
 {
     friend class Singleton<CollisionManager>;
 	friend class Collider2D;
+    friend class RigidBody2D;
     friend class SceneManager;
     friend class Engine;
     friend class PhysicsManager;
+    friend class Scene;
+
+public:
+    static constexpr int kLayerCount = 32;
+
+    struct Config
+    {
+        std::vector<std::pair<int, int>> ignoreLayerPairs;  // pares de indices de capa (0..31)
+    };
+
+    // Matriz de colision entre capas (simetrica, global a todas las escenas).
+    // Por defecto todas con todas. Se aplica antes que layer/mask de cada collider:
+    // los pares de capas que no interactuan no llegan ni a generarse en el broadphase.
+    void SetLayerCollision(int layerA, int layerB, bool collide) noexcept;
+    bool GetLayerCollision(int layerA, int layerB) const noexcept;
+    void ResetLayerCollisions() noexcept;
+
+    // Consultas contra el broadphase (arboles por capa y BVH estaticos), sin reservar
+    // memoria: los resultados van a buffers del que llama. dir no hace falta normalizarla.
+    // El broadphase refleja el ultimo paso de deteccion; si se teletransportan objetos y
+    // se consulta en el mismo frame, llamar antes a SyncTransforms().
+    bool Raycast(const Vec2& origin, const Vec2& dir, float maxDistance, RaycastHit2D& hit, const QueryFilter2D& filter = {}) noexcept;
+    int  RaycastAll(const Vec2& origin, const Vec2& dir, float maxDistance, RaycastHit2D* hits, int maxHits, const QueryFilter2D& filter = {}) noexcept;   // por distancia
+    bool CircleCast(const Vec2& origin, float radius, const Vec2& dir, float maxDistance, RaycastHit2D& hit, const QueryFilter2D& filter = {}) noexcept;
+    bool BoxCast(const Vec2& origin, const Vec2& size, float angleDeg, const Vec2& dir, float maxDistance, RaycastHit2D& hit, const QueryFilter2D& filter = {}) noexcept;
+
+    // Escriben hasta maxResults colliders y devuelven cuantos han escrito
+    int OverlapPoint(const Vec2& point, Collider2D** results, int maxResults, const QueryFilter2D& filter = {}) noexcept;
+    int OverlapCircle(const Vec2& center, float radius, Collider2D** results, int maxResults, const QueryFilter2D& filter = {}) noexcept;
+    int OverlapBox(const Vec2& center, const Vec2& size, float angleDeg, Collider2D** results, int maxResults, const QueryFilter2D& filter = {}) noexcept;
+
+    // Reajusta los proxies dinamicos a los Transforms actuales
+    void SyncTransforms() noexcept;
 
 private:
     CollisionManager() = default;
     ~CollisionManager() = default;
 
-    bool Init() noexcept;
+    bool Init(const Config& cfg) noexcept;
     void Shutdown() noexcept;
 
     void RegisterCollider(Collider2D* c) noexcept;
     void RemoveCollider(Collider2D* c) noexcept;
     void SetColliderActive(Collider2D* c, bool active) noexcept;
+
+    // Recalcula la clase (static/dinamico) de un collider o de los colliders en
+    // Auto de un objeto y sus hijos (al cambiar su RigidBody2D)
+    void RefreshCollider(Collider2D* c) noexcept;
+    void RefreshColliders(GameObject* go) noexcept;
     void ClearAll() noexcept;
 
-    // Detecta solapes AABB y despacha On*Enter/Stay/Exit (collision/trigger).
+    // Mundos por escena: una escena persistente aparca su estado al desactivarse
+    // y lo recupera al volver, sin re-registrar colliders ni reconstruir pares. O(1).
+    void SuspendWorld(const Scene* scene) noexcept;
+    bool ResumeWorld(const Scene* scene) noexcept;
+    void DiscardWorld(const Scene* scene) noexcept;
+
+    // Despacha On*Enter/Stay/Exit (collision/trigger). Si el paso de fisica ya dejo
+    // los contactos de su ultimo substep se reutilizan; si no, detecta aqui.
     // No resuelve posiciones ni fsicas.
     void DetectAndDispatch() noexcept;
 
-    std::unordered_map<Collider2D*, bool> mRegisteredColliders;
-
     CollisionManager(const CollisionManager&) = delete;
     CollisionManager& operator=(const CollisionManager&) = delete;
     CollisionManager(CollisionManager&&) = delete;
@@ -59,49 +150,263 @@ private:
         return (hi << 32) | lo;
     }
 
-    struct PairInfo
+    // Un RigidBody2D que desaparece deja de ser el cuerpo de sus pares
+    void ForgetBody_(const RigidBody2D* b) noexcept;
+
+    // Registro del par en la tabla (nullptr si no se ha tocado); para el solver
+    inline PairTable::Pair* FindPair_(const GameObject* a, const GameObject* b) noexcept
+    {
+        return mWorld.pairs.Find(MakeKey_(a->GetID(), b->GetID()));
+    }
+
+
+    struct ColliderEntry
+    {
+        bool active = true;
+        bool isStatic = false;                      // horneado en el BVH estatico
+        bool inTriggerTree = false;                 // el proxy vive en World::triggerTrees
+        uint8_t bucket = 0;                         // cubo de capa del proxy
+        int32_t proxy = DynamicAABBTree::kNull;    // solo los activos no estaticos estan en un arbol
+    };
+
+    // Cache SoA de colliders: forma en mundo y datos de filtrado en arrays densos,
+    // rellenados en una sola pasada (por substep en dinamicos, al hornear en estaticos).
+    // Broadphase y narrowphase solo leen de aqui.
+    struct ColliderCache
+    {
+        // kAsleep: rellenado con el cuerpo ya dormido (la forma sigue valida mientras duerma)
+        enum Flags : uint8_t { kCircle = 1 << 0, kTrigger = 1 << 1, kAsleep = 1 << 2 };
+
+        std::vector<Collider2D*>  col;
+        std::vector<GameObject*>  go;
+        std::vector<RigidBody2D*> body;     // cuerpo asociado (puede ser nullptr)
+        std::vector<EntityID>     id;
+        std::vector<Vec2>         center;
+        std::vector<Vec2>         half;     // Box
+        std::vector<Vec2>         rot;      // Box: (cos, sin)
+        std::vector<float>        radius;   // Circle
+        std::vector<Rect>         aabb;
+        std::vector<LayerBits>    layer;
+        std::vector<LayerBits>    mask;
+        std::vector<uint8_t>      flags;
+
+        inline size_t Size() const noexcept { return col.size(); }
+        void Resize(size_t n);
+        void Fill(size_t i, Collider2D* c) noexcept;
+    };
+
+    // Colliders no estaticos en orden determinista (ID, puntero). broadRank_ es el indice.
+    struct DynamicRef
+    {
+        Collider2D* col = nullptr;                  // nullptr = hueco pendiente de compactar
+        int32_t proxy = DynamicAABBTree::kNull;
+        bool trigger = false;                       // proxy en triggerTrees
+        uint8_t bucket = 0;
+    };
+
+    // Referencia a una entrada de cache: bit alto = cache estatica
+    static constexpr uint32_t kStaticRef = 0x80000000u;
+
+    // Estado de colision de una escena
+    struct World
     {
-        GameObject* a = nullptr;
-        GameObject* b = nullptr;
-        Collider2D* colA = nullptr;
-        Collider2D* colB = nullptr;
-        bool isTriggerPair = false;
+        std::unordered_map<Collider2D*, ColliderEntry> colliders;
+        // Broadphase por cubos de capa (bit mas bajo de Collider2D::layer): un arbol
+        // de solidos y otro de triggers por cubo, y un BVH estatico por cubo
+        DynamicAABBTree trees[kLayerCount];         // solidos no estaticos (kinematic/dynamic)
+        DynamicAABBTree triggerTrees[kLayerCount];  // triggers no estaticos
+        LayerBits bucketLayers[kLayerCount]{};      // union de las capas de cada cubo dinamico
+        LayerBits usedBuckets = 0;                  // cubos dinamicos con algun proxy
+
+        std::vector<DynamicRef> dynamics;           // lista densa de no estaticos activos
+        bool dynamicsDirty = false;
+
+        StaticBVH statics[kLayerCount];             // colliders Static horneados
+        LayerBits staticBucketLayers[kLayerCount]{};
+        LayerBits usedStaticBuckets = 0;
+        ColliderCache staticCache;                  // indexado por item de los BVH (ordenado por cubo)
+        bool staticsDirty = false;
+
+        PairTable pairs;                            // pares persistentes (Enter/Stay/Exit por stamps)
+        uint32_t stamp = 0;                         // pasada de deteccion actual
+        uint64_t version = 0;                       // cambia al registrar o quitar colliders (PhysicsManager::State)
     };
 
-    std::unordered_map<uint64_t, PairInfo> mPrevInfo;
-    std::unordered_map<uint64_t, PairInfo> mCurrInfo;
+    World mWorld;                                           // mundo de la escena activa
+    std::unordered_map<const Scene*, World> mSuspendedWorlds;
+    uint64_t mVersionCounter = 0;
 
-    std::unordered_set<uint64_t> mPrevPairs;
-    std::unordered_set<uint64_t> mCurrPairs;
+    LayerBits mLayerMatrix[kLayerCount]{};                  // fila i: capas que interactuan con la capa i
+
+    // Scratch del broadphase (se reutiliza entre llamadas)
+    ColliderCache mDynCache;                                // dinamicos, por substep
+    std::vector<uint8_t> mDynAsleep;                        // por rank: cuerpo dormido (no consulta)
+    std::vector<std::pair<uint32_t, uint32_t>> mBroadPairs; // (rank, ref)
+    std::vector<Collider2D*> mBakeList;
+    std::vector<uint64_t> mPairErase;
+    std::vector<CollisionEvent2D> mEvents;                  // eventos del dispatch, agrupados por receptor
+
+    // Narrowphase por lotes: candidatos (refA, refB) tras filtro + AABB, y si pueden tocar
+    std::vector<std::pair<uint32_t, uint32_t>> mNarrowCand;
+    std::vector<std::pair<uint32_t, uint32_t>> mTriggerCand;   // pares con trigger: solo solape
+    std::vector<uint8_t> mNarrowMaybe;
+    narrow::CircleCircleBatch mBatchCC;
+    narrow::BoxCircleBatch mBatchBC;
+    narrow::BoxBoxBatch mBatchBB;
+    std::vector<uint32_t> mBatchIdxCC, mBatchIdxBC, mBatchIdxBB;
+    std::vector<uint8_t> mBatchMaybe;
+
+    // Narrowphase multihilo: cada job procesa un tramo contiguo de mNarrowCand en su
+    // propio buffer y se juntan en orden de tramo (mismo orden que en un solo hilo)
+    struct NarrowJob
+    {
+        std::vector<NarrowContact> contacts;
+        int tests = 0;
+    };
+    std::vector<NarrowJob> mNarrowJobs;
 
     int nBroadphaseTestsThisFrame = 0;
     int nNarrowphaseTestsThisFrame = 0;
+    int nNarrowCulledThisFrame = 0;         // descartados por el filtro por lotes
+    int nNarrowJobsThisFrame = 0;           // tramos del narrowphase (1 = en serie)
+    int nTriggerTestsThisFrame = 0;         // tests de solape booleanos (pares con trigger)
+    size_t nTriggerOverlapsThisFrame = 0;
     size_t nContactsBuiltThisFrame = 0;
+    size_t nActivePairs = 0;
+    size_t nEventsThisFrame = 0;            // eventos entregados (solo a objetos que escuchan)
+
+    // Contactos y solapes de trigger del ultimo substep de PhysicsManager::Step (los recoge DetectAndDispatch)
+    std::vector<NarrowContact> mStepContacts;
+    std::vector<NarrowContact> mStepTriggers;
+    std::vector<NarrowContact> mDispatchContacts;   // scratch del camino sin fisica
+    std::vector<NarrowContact> mDispatchTriggers;
+    bool mHasStepContacts = false;
+    uint32_t mStepContactsStamp = 0;
+
+    // Pasadas de deteccion (BuildContacts_) del ultimo paso fijo: debe ser == substeps
+    int nDetectionPasses = 0;
+    int nDetectionPassesLastStep = 0;
+    std::uint64_t nDispatchReused = 0;      // dispatches con los contactos del substep
+    std::uint64_t nDispatchFallback = 0;    // dispatches que tuvieron que detectar
+
+    void SyncEntry_(Collider2D* c, ColliderEntry& e, bool rebake) noexcept;
+    void BakeStatics_() noexcept;
+    void SortDynamics_() noexcept;
+    static bool ColliderLess_(const Collider2D* a, const Collider2D* b) noexcept;
+
+    static inline uint8_t BucketOf_(LayerBits layer) noexcept
+    {
+        return layer ? (uint8_t)std::countr_zero(layer) : 0;
+    }
+
+    // Capas con las que puede interactuar un collider de capas 'layer' (union de filas)
+    inline LayerBits LayerRow_(LayerBits layer) const noexcept
+    {
+        LayerBits row = 0;
+        for (LayerBits bits = layer; bits; bits &= bits - 1)
+            row |= mLayerMatrix[std::countr_zero(bits)];
+        return row;
+    }
 
-    void BuildContacts_(std::vector<NarrowContact>& out) noexcept;
-    void Dispatch_(const std::vector<NarrowContact>& contacts) noexcept;
+    inline DynamicAABBTree& TreeOf_(bool trigger, uint8_t bucket) noexcept
+    {
+        return trigger ? mWorld.triggerTrees[bucket] : mWorld.trees[bucket];
+    }
+
+    inline const ColliderCache& CacheOf_(uint32_t ref) const noexcept
+    {
+        return (ref & kStaticRef) ? mWorld.staticCache : mDynCache;
+    }
+
+    bool Narrow_(const ColliderCache& ca, uint32_t ia, const ColliderCache& cb, uint32_t ib, ContactPoint& cp, ContactManifold& m) noexcept;
+
+    void CullCandidates_() noexcept;
+    void NarrowRange_(size_t begin, size_t end, NarrowJob& job) noexcept;    // thread-safe (solo lee)
+    void TriggerOverlaps_(std::vector<NarrowContact>& triggers) noexcept;
+    bool ResolveOwners_(const ColliderCache& ca, uint32_t ia, const ColliderCache& cb, uint32_t ib, NarrowContact& nc) const noexcept;
+    void TouchPair_(const NarrowContact& c) noexcept;
+
+    // Collider2D::pairKeys_: se mantiene al insertar, reasignar y borrar pares
+    static void LinkPair_(Collider2D* c, uint64_t key) noexcept;
+    static void UnlinkPair_(Collider2D* c, uint64_t key) noexcept;
+    // Despierta los cuerpos dormidos de los pares de c (c desaparece o cambia)
+    void WakePairsOf_(const Collider2D* c) noexcept;
+    // callback(Pair&) sobre los pares de c, sin recorrer la tabla. No insertar ni borrar dentro.
+    template<class F>
+    void ForEachPairOf_(const Collider2D* c, F&& callback)
+    {
+        for (uint64_t key : c->pairKeys_)
+        {
+            PairTable::Pair* p = mWorld.pairs.Find(key);
+            if (p && (p->colA == c || p->colB == c)) callback(*p);
+        }
+    }
+    static bool AtRest_(const RigidBody2D* body, const Collider2D* col) noexcept;
+    // PhysicsManager::RestoreState: tabla de pares guardada y la cache de dinamicos a rehacer
+    void RestorePairs_(const PairTable& pairs, uint32_t stamp) noexcept;
+    // Forma en mundo para la cache: dentro de PhysicsManager::Step, con la pose del cuerpo del substep
+    static Collider2D::WorldShape CacheShapeOf_(const Collider2D* c, const RigidBody2D* body) noexcept;
 
-    static bool ShouldTest(const Collider2D& a, const Collider2D& b) noexcept;
+    // contacts: solo pares solidos (entrada del solver). triggers: solapes con al menos
+    // un trigger, sin manifold (solo para eventos)
+    void BuildContacts_(std::vector<NarrowContact>& contacts, std::vector<NarrowContact>& triggers) noexcept;
+    void SetStepContacts_(std::vector<NarrowContact>& contacts, std::vector<NarrowContact>& triggers) noexcept;   // swap, sin copia
+    void Dispatch_(const std::vector<NarrowContact>& contacts, const std::vector<NarrowContact>& triggers) noexcept;
 
-    // Narrow-phase:
-    static bool TestOBB_OBB(const Collider2D::OrientedBox2D& A,
-        const Collider2D::OrientedBox2D& B) noexcept;   // SAT 2D
+    static bool ShouldTest(const ColliderCache& ca, uint32_t ia, const ColliderCache& cb, uint32_t ib) noexcept;
+
+    // Narrow-phase booleano (pares con trigger: solo importa si solapan). rot = (cos, sin)
+    static bool TestOBB_OBB(const Vec2& ac, const Vec2& aHalf, const Vec2& aRot,
+        const Vec2& bc, const Vec2& bHalf, const Vec2& bRot) noexcept;   // SAT 2D
     static bool TestCircle_Circle(const Vec2& ca, float ra,
         const Vec2& cb, float rb) noexcept;
-    static bool TestOBB_Circle(const Collider2D::OrientedBox2D& box,
+    static bool TestOBB_Circle(const Vec2& bc, const Vec2& half, const Vec2& rot,
         const Vec2& cc, float r) noexcept;
+    static bool Overlap_(const ColliderCache& ca, uint32_t ia, const ColliderCache& cb, uint32_t ib) noexcept;
+
+    // Consultas: forma de un collider en mundo (estaticos desde la cache horneada)
+    struct QueryShape_
+    {
+        Collider2D* col = nullptr;
+        bool circle = false;
+        Vec2 center, half, rot;
+        float radius = 0.f;
+        Rect aabb;
+    };
+
+    void PrepareQueries_() noexcept;
+    bool AcceptQuery_(const Collider2D* c, const QueryFilter2D& filter) const noexcept;
+    static QueryShape_ ShapeOf_(Collider2D* c) noexcept;
+    QueryShape_ StaticShapeOf_(uint32_t item) const noexcept;
+
+    // callback(const QueryShape_&) -> bool (false = parar)
+    template<class F> void QueryShapes_(const Rect& aabb, const QueryFilter2D& filter, F&& callback) noexcept;
+    // callback(const QueryShape_&, float maxT) -> float (ver DynamicAABBTree::RayCast)
+    template<class F> void RayCastShapes_(const Vec2& origin, const Vec2& dir, float maxT, const QueryFilter2D& filter, F&& callback) noexcept;
+
+    // Barrido de la forma s (circulo si circle, radio 0 = rayo) a lo largo de dir (unitaria)
+    static bool CastShape_(const QueryShape_& s, const Vec2& dir, float maxT, const QueryShape_& target, float& t, Vec2& normal, Vec2& point) noexcept;
+    bool Cast_(const QueryShape_& s, const Vec2& dir, float maxDistance, RaycastHit2D& hit, const QueryFilter2D& filter) noexcept;
+    static QueryShape_ MakeQueryBox_(const Vec2& center, const Vec2& size, float angleDeg) noexcept;
+
+    // CCD (PhysicsManager): primer collider solido que toca col al barrerlo delta hasta
+    // su pose del substep. Filtro del broadphase (matriz, mask, mismo cuerpo), sin
+    // triggers ni lo que ya solapaba al empezar. normal apunta hacia col.
+    bool SweepCollider_(Collider2D* col, const RigidBody2D* body, const Vec2& delta, float& toi, Vec2& normal) noexcept;
 
     // Broad-phase (ya lo tienes): AABB contra AABB
     static bool TestBoxBox(const Rect& a, const Rect& b) noexcept;
 
-    bool Contact_OBB_Circle(const Vec2& cc, float r, const Vec2& bc, const Vec2& half, float rotDeg, ContactPoint& out) noexcept;
+    // rot = (cos, sin) del angulo de la OBB
+    bool Contact_OBB_Circle(const Vec2& cc, float r, const Vec2& bc, const Vec2& half, const Vec2& rot, ContactPoint& out) noexcept;
 
     struct MinAxisResult { Vec2 axis; float depth; bool valid; };
     MinAxisResult SAT_MinAxis(const Collider2D::OrientedBox2D& A, const Collider2D::OrientedBox2D& B);
 
-    bool Contact_OBB_OBB(const Vec2& ac, const Vec2& aHalf, float aRotDeg,
-        const Vec2& bc, const Vec2& bHalf, float bRotDeg,
-        ContactPoint& out) noexcept;
+    // Manifold de hasta 2 puntos: cara incidente recortada contra la de referencia
+    bool Contact_OBB_OBB(const Vec2& ac, const Vec2& aHalf, const Vec2& aRot,
+        const Vec2& bc, const Vec2& bHalf, const Vec2& bRot,
+        ContactPoint& out, ContactManifold& manifold) noexcept;
 
     bool Contact_Circle_Circle(const Vec2& ca, float ra,
         const Vec2& cb, float rb,
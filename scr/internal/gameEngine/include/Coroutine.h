@@ -0,0 +1,235 @@
+#pragma once
+
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <functional>
+
+class Behaviour;
+class CoroutineScheduler;
+struct CoroutineNode;
+
+// =========================
+// Coroutines (C++20)
+// =========================
+//
+// Un Behaviour puede declarar metodos que devuelven Coroutine y lanzarlos con
+// StartCoroutine():
+//
+//   Coroutine Spawn()
+//   {
+//       while (true)
+//       {
+//           co_await WaitForSeconds(5.f);
+//           ...
+//       }
+//   }
+//
+//   void Start() override { StartCoroutine(Spawn()); }
+//
+// La corrutina corre hasta su primer co_await dentro de StartCoroutine y la
+// reanuda el CoroutineScheduler de la escena. Una corrutina dormida no cuesta
+// nada por frame (esta colgada en una rueda de timers), a diferencia de un
+// Update que cuenta tiempo. Se cancelan solas en OnDisable / OnDestroy.
+// Si su objeto esta suspendido (chunk fuera de rango) o congelado por el LOD de
+// la simulacion no se reanudan: lo que vence se aparca y sigue al volver. Con el
+// objeto en LOD Reduced solo se reanudan en los frames / pasos en que le toca.
+
+// Lista intrusiva (doble enlace): insertar y quitar en O(1)
+struct CoroutineList
+{
+    CoroutineNode* head = nullptr;
+    CoroutineNode* tail = nullptr;
+
+    bool Empty() const noexcept { return head == nullptr; }
+};
+
+// Estado de planificacion de una corrutina (vive dentro de su promise)
+struct CoroutineNode
+{
+    // Lista de espera en la que esta (slot de la rueda, fixed, polling...)
+    CoroutineNode* prev = nullptr;
+    CoroutineNode* next = nullptr;
+    CoroutineList* list = nullptr;
+
+    // Lista de corrutinas del Behaviour duenyo
+    CoroutineNode* ownerPrev = nullptr;
+    CoroutineNode* ownerNext = nullptr;
+
+    Behaviour* owner = nullptr;
+    CoroutineScheduler* scheduler = nullptr;
+    std::coroutine_handle<> handle;
+
+    uint64_t expireTick = 0;            // WaitForSeconds (ticks de 1 ms)
+    std::function<bool()> predicate;    // WaitUntil
+    CoroutineList* heldFrom = nullptr;  // cola a la que vuelve al soltarse (ver Hold_)
+
+    bool running = false;               // dentro de resume()
+    bool cancelled = false;             // parada mientras corria
+};
+
+class Coroutine
+{
+public:
+    struct promise_type : CoroutineNode
+    {
+        Coroutine get_return_object() noexcept
+        {
+            auto h = std::coroutine_handle<promise_type>::from_promise(*this);
+            handle = h;
+            return Coroutine{ h };
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+
+    Coroutine() noexcept = default;
+    Coroutine(Coroutine&& o) noexcept : mHandle(o.mHandle) { o.mHandle = nullptr; }
+    Coroutine& operator=(Coroutine&& o) noexcept
+    {
+        if (this != &o)
+        {
+            if (mHandle) mHandle.destroy();
+            mHandle = o.mHandle;
+            o.mHandle = nullptr;
+        }
+        return *this;
+    }
+
+    Coroutine(const Coroutine&) = delete;
+    Coroutine& operator=(const Coroutine&) = delete;
+
+    // Si nunca se llego a lanzar, el frame se libera aqui
+    ~Coroutine() { if (mHandle) mHandle.destroy(); }
+
+private:
+    friend class Behaviour;
+
+    explicit Coroutine(std::coroutine_handle<promise_type> h) noexcept : mHandle(h) {}
+
+    // StartCoroutine se queda con el frame
+    std::coroutine_handle<promise_type> Release() noexcept
+    {
+        auto h = mHandle;
+        mHandle = nullptr;
+        return h;
+    }
+
+    std::coroutine_handle<promise_type> mHandle;
+};
+
+// =========================
+// Awaitables
+// =========================
+
+// Espera x segundos de juego (deltaTime, afectado por timeScale)
+struct WaitForSeconds
+{
+    float seconds = 0.f;
+
+    explicit WaitForSeconds(float s) noexcept : seconds(s) {}
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<Coroutine::promise_type> h) const noexcept;
+    void await_resume() const noexcept {}
+};
+
+// Reanuda tras el siguiente paso fijo de la escena
+struct WaitForFixedUpdate
+{
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<Coroutine::promise_type> h) const noexcept;
+    void await_resume() const noexcept {}
+};
+
+// Reanuda cuando pred() devuelve true. El predicado se evalua una vez por frame
+// (es la unica espera que si se consulta cada frame).
+struct WaitUntil
+{
+    std::function<bool()> pred;
+
+    explicit WaitUntil(std::function<bool()> p) noexcept : pred(std::move(p)) {}
+
+    bool await_ready() const { return pred && pred(); }
+    void await_suspend(std::coroutine_handle<Coroutine::promise_type> h) noexcept;
+    void await_resume() const noexcept {}
+};
+
+// =========================
+// CoroutineScheduler
+// =========================
+//
+// Uno por escena. Los WaitForSeconds van a una rueda de timers jerarquica
+// (ticks de 1 ms, 4 niveles de 64 slots, ~4.6 h de rango; lo que quede fuera
+// se re-encola al cascadear). Avanzar la rueda solo toca los slots que vencen,
+// y con la rueda vacia no hace nada.
+class CoroutineScheduler
+{
+    friend class Behaviour;
+    friend class Scene;
+    friend struct WaitForSeconds;
+    friend struct WaitForFixedUpdate;
+    friend struct WaitUntil;
+
+public:
+    CoroutineScheduler() noexcept = default;
+    ~CoroutineScheduler() noexcept;
+
+    CoroutineScheduler(const CoroutineScheduler&) = delete;
+    CoroutineScheduler& operator=(const CoroutineScheduler&) = delete;
+
+    inline size_t GetCount() const noexcept { return mCount; }
+
+private:
+    static constexpr int kSlotBits = 6;
+    static constexpr int kSlots = 1 << kSlotBits;
+    static constexpr int kLevels = 4;
+    static constexpr uint64_t kSlotMask = kSlots - 1;
+    static constexpr uint64_t kMaxDelta = (1ull << (kSlotBits * kLevels)) - 1;
+
+    // Llamados desde Scene
+    void Update(float dt) noexcept;     // timers + WaitUntil
+    void FixedUpdate() noexcept;        // WaitForFixedUpdate
+
+    // Llamados desde Behaviour
+    void Start(CoroutineNode* n) noexcept;
+    void StopAll(Behaviour* owner) noexcept;
+
+    // Llamado desde Scene cuando el objeto del duenyo vuelve a simularse
+    void ResumeHeld(Behaviour* owner) noexcept;
+
+    // Llamados desde los awaitables
+    void WaitTicks(CoroutineNode* n, float seconds) noexcept;
+    void WaitFixed(CoroutineNode* n) noexcept;
+    void WaitPredicate(CoroutineNode* n) noexcept;
+
+    // Dueno que no corre ahora: aparca n y devuelve true. Suspendido o Frozen: a mHeld
+    // (back = cola a la que vuelve); Reduced sin tick: a retry, se reintenta despues
+    bool Hold_(CoroutineNode* n, CoroutineList& back, CoroutineList& retry, bool fixed) noexcept;
+    void Resume_(CoroutineNode* n) noexcept;
+    void Release_(CoroutineNode* n) noexcept;
+
+    void InsertTimer_(CoroutineNode* n) noexcept;
+    void Advance_(uint64_t target) noexcept;
+    void Cascade_(int level, uint64_t index) noexcept;
+
+    static void PushBack_(CoroutineList& l, CoroutineNode* n) noexcept;
+    static void Unlink_(CoroutineNode* n) noexcept;
+    static void MoveAll_(CoroutineList& from, CoroutineList& to) noexcept;
+
+    CoroutineList mWheel[kLevels][kSlots];
+    CoroutineList mDue;             // timers vencidos pendientes de reanudar
+    CoroutineList mFixed;           // WaitForFixedUpdate
+    CoroutineList mPolled;          // WaitUntil
+    CoroutineList mRunning;         // lote que se esta reanudando
+    CoroutineList mHeld;            // listas para reanudar pero con el dueno suspendido
+    CoroutineList mDeferred;        // listas, con el dueno en LOD Reduced sin tick este frame
+
+    double mTimeMs = 0.0;           // tiempo de juego acumulado
+    uint64_t mBase = 0;             // siguiente tick por procesar
+    size_t mTimers = 0;             // corrutinas colgadas en la rueda
+    size_t mCount = 0;              // corrutinas vivas
+};
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "BaseTypes.h"
+
+// =========================
+// DynamicAABBTree
+// =========================
+//
+// Arbol binario de AABBs para el broadphase (estilo Box2D):
+// - Cada proxy guarda un AABB "engordado" (margen kMargin). Mientras el AABB
+//   real siga dentro, mover el proxy no toca el arbol.
+// - Insercion por coste de perimetro y rotaciones para mantenerlo equilibrado.
+// - Query(aabb) recorre solo las ramas que solapan: ~O(log n) por consulta.
+class DynamicAABBTree
+{
+public:
+    static constexpr int32_t kNull = -1;
+    static constexpr float kMargin = 0.1f;     // unidades de mundo
+
+    DynamicAABBTree() noexcept = default;
+
+    int32_t CreateProxy(const Rect& aabb, void* userData) noexcept;
+    void DestroyProxy(int32_t proxy) noexcept;
+
+    // Devuelve true si el proxy se ha tenido que reinsertar
+    bool MoveProxy(int32_t proxy, const Rect& aabb) noexcept;
+
+    inline void* GetUserData(int32_t proxy) const noexcept { return mNodes[proxy].userData; }
+    inline const Rect& GetFatAABB(int32_t proxy) const noexcept { return mNodes[proxy].aabb; }
+
+    inline size_t GetProxyCount() const noexcept { return mProxyCount; }
+    inline int GetHeight() const noexcept { return (mRoot == kNull) ? 0 : mNodes[mRoot].height; }
+
+    void Clear() noexcept;
+
+    // callback(int32_t proxy) -> bool (false = parar)
+    template<class F>
+    void Query(const Rect& aabb, F&& callback) const
+    {
+        if (mRoot == kNull) return;
+
+        mStack.clear();
+        mStack.push_back(mRoot);
+
+        while (!mStack.empty())
+        {
+            const int32_t id = mStack.back();
+            mStack.pop_back();
+
+            const Node& node = mNodes[id];
+            if (!node.aabb.Overlaps(aabb)) continue;
+
+            if (node.IsLeaf())
+            {
+                if (!callback(id)) return;
+            }
+            else
+            {
+                mStack.push_back(node.child1);
+                mStack.push_back(node.child2);
+            }
+        }
+    }
+
+    // Recorre los proxies cuyo AABB corta el segmento origin + dir * t, t en [0, maxT].
+    // callback(int32_t proxy, float maxT) -> float: nuevo maxT (recorta el resto
+    // del recorrido; devolver maxT para seguir igual, < 0 para parar)
+    template<class F>
+    void RayCast(const Vec2& origin, const Vec2& dir, float maxT, F&& callback) const
+    {
+        if (mRoot == kNull) return;
+
+        mStack.clear();
+        mStack.push_back(mRoot);
+
+        while (!mStack.empty())
+        {
+            const int32_t id = mStack.back();
+            mStack.pop_back();
+
+            const Node& node = mNodes[id];
+            if (!node.aabb.IntersectsRay(origin, dir, maxT)) continue;
+
+            if (node.IsLeaf())
+            {
+                maxT = callback(id, maxT);
+                if (maxT < 0.f) return;
+            }
+            else
+            {
+                mStack.push_back(node.child1);
+                mStack.push_back(node.child2);
+            }
+        }
+    }
+
+private:
+    struct Node
+    {
+        Rect aabb;
+        void* userData = nullptr;
+        int32_t parent = kNull;     // siguiente libre si el nodo esta en la free list
+        int32_t child1 = kNull;
+        int32_t child2 = kNull;
+        int32_t height = -1;        // hoja = 0, libre = -1
+
+        inline bool IsLeaf() const noexcept { return child1 == kNull; }
+    };
+
+    int32_t AllocateNode_() noexcept;
+    void FreeNode_(int32_t id) noexcept;
+
+    void InsertLeaf_(int32_t leaf) noexcept;
+    void RemoveLeaf_(int32_t leaf) noexcept;
+    int32_t Balance_(int32_t a) noexcept;
+
+    std::vector<Node> mNodes;
+    int32_t mRoot = kNull;
+    int32_t mFreeList = kNull;
+    size_t mProxyCount = 0;
+
+    mutable std::vector<int32_t> mStack;    // pila de Query (sin allocs por consulta)
+};
@@ -31,6 +31,7 @@ private:
         bool multiThreading = false;
 		bool logStats = false;
         bool logErrors = true;
+        int workerThreads = 0;      // hilos del JobSystem (0 = nucleos - 1, < 0 = ninguno)
 
         struct Window
         {
@@ -119,8 +120,26 @@ private:
             float penetrationPercent = 0.8f;
             int maxSubsteps = 8;
             float ccdMinSizeFactor = 0.5f;
+            bool ccdSubstepping = false;
+            int velocityIterations = 4;
+            float solverTolerance = 1e-3f;
+            bool enableSleeping = true;
+            float sleepLinearVelocity = 0.05f;
+            float sleepAngularVelocity = 0.05f;
+            float timeToSleep = 0.5f;
         } physics;
 
+        struct Collision
+        {
+            std::vector<std::pair<int, int>> ignoreLayerPairs;     // pares de capas (0..31) que no colisionan
+        } collision;
+
+        struct Scenes
+        {
+            float activationBudgetMs = 0.f;     // 0 = sin limite
+            int activationBudgetCount = 0;      // 0 = sin limite
+        } scenes;
+
         Config() noexcept = default;
     };
 
@@ -3,6 +3,9 @@
 #include <vector>
 #include <memory>
 #include <string>
+#include <cstdint>
+#include <type_traits>
+#include <concepts>
 
 #include "Property.h"
 #include "Scene.h"
@@ -23,12 +26,37 @@ struct ContactPoint {
   float penetration; 
 };
 
+// Puntos de contacto de un evento: buffer fijo, sin memoria dinamica.
+// Se lee igual que un vector (size, empty, [], for).
+struct ContactList {
+  static constexpr uint32_t kCapacity = 2;
+
+  ContactPoint points[kCapacity]{};
+  uint32_t count = 0;
+
+  inline void push_back(const ContactPoint& cp) noexcept { if (count < kCapacity) points[count++] = cp; }
+  inline void clear() noexcept { count = 0; }
+
+  inline uint32_t size() const noexcept { return count; }
+  inline bool empty() const noexcept { return count == 0; }
+  inline const ContactPoint& operator[](uint32_t i) const noexcept { return points[i]; }
+  inline const ContactPoint* begin() const noexcept { return points; }
+  inline const ContactPoint* end() const noexcept { return points + count; }
+};
+
 struct CollisionInfo2D {
   GameObject* self = nullptr;
   GameObject* other = nullptr;
-  Collider2D* selfCollider;
-  Collider2D* otherCollider;
-  std::vector<ContactPoint> contacts; // ya lo tienes definido
+  Collider2D* selfCollider = nullptr;
+  Collider2D* otherCollider = nullptr;
+  ContactList contacts;
+};
+
+// Evento pendiente de entregar (lo encola CollisionManager::Dispatch_)
+struct CollisionEvent2D {
+  uint8_t hook = 0;         // GameObject::ListenerHook
+  uint32_t seq = 0;         // orden de generacion (desempate al agrupar)
+  CollisionInfo2D info;     // info.self = receptor
 };
 
 class GameObject
@@ -36,6 +64,16 @@ class GameObject
 	friend class Transform;
 	friend class CollisionManager;
     friend class Scene;
+    friend class SceneSnapshot;
+    friend class PhysicsManager;
+    friend class CoroutineScheduler;
+
+public:
+    // Prioridad de activacion cuando la escena reparte Awake/Start entre frames
+    // (SceneManager::activationBudgetMs / activationBudgetCount).
+    //  - Normal:    puede esperar a frames siguientes si se agota el presupuesto.
+    //  - Immediate: se activa siempre en el mismo frame (jugador, camara, UI...).
+    enum class ActivationPriority : uint8_t { Normal, Immediate };
 
 private:
     explicit GameObject(const std::string& name, EntityID id, Scene* scene) noexcept;
@@ -59,13 +97,29 @@ private:
     void Update(float dt);
     void Render();
 
-    void OnCollisionEnter(const CollisionInfo2D&);
-    void OnCollisionStay(const CollisionInfo2D&);
-    void OnCollisionExit(const CollisionInfo2D&);
+    // Hooks de colision/trigger que overridea algun Behaviour del objeto.
+    // Se detectan en AddComponent; CollisionManager solo genera eventos para estos.
+    enum ListenerHook : uint8_t
+    {
+        kCollisionEnter = 1 << 0,
+        kCollisionStay  = 1 << 1,
+        kCollisionExit  = 1 << 2,
+        kTriggerEnter   = 1 << 3,
+        kTriggerStay    = 1 << 4,
+        kTriggerExit    = 1 << 5,
+    };
+
+    struct CollisionListener
+    {
+        Behaviour* behaviour = nullptr;
+        uint8_t hooks = 0;
+    };
+
+    template<class T>
+    static constexpr uint8_t ListenerHooks_() noexcept;
 
-    void OnTriggerEnter(const CollisionInfo2D&);
-    void OnTriggerStay(const CollisionInfo2D&);
-    void OnTriggerExit(const CollisionInfo2D&);
+    // Entrega un lote de eventos cuyo receptor es este objeto (en orden)
+    void DeliverCollisionEvents_(const CollisionEvent2D* events, size_t count);
 
     // Aadir/quitar hijos (se usan desde SetParent)
     void AddChild(GameObject* child) noexcept;      // no transfiere ownership
@@ -85,6 +139,14 @@ private:
     inline std::string GetTag() const noexcept { return mTag; }
     inline void SetTag(std::string tag) noexcept { mTag = tag; }
     inline GameObject* GetParent() const noexcept { return mParent; }
+    inline ActivationPriority GetActivationPriority() const noexcept { return mActivationPriority; }
+    inline void SetActivationPriority(ActivationPriority p) noexcept { mActivationPriority = p; }
+    inline bool IsStreamedOut() const noexcept { return mStreamedOut; }
+    inline bool IsStreamingPinned() const noexcept { return mPinned; }
+    void SetStreamingPinned(bool pinned) noexcept;
+    inline SimulationLod GetSimulationLod() const noexcept { return mLodTier; }
+    inline bool IsSimulationLodPinned() const noexcept { return mLodPinned; }
+    inline void SetSimulationLodPinned(bool pinned) noexcept { mLodPinned = pinned; }
 
     std::string mName;
     std::string mTag;
@@ -97,11 +159,31 @@ private:
     std::vector<std::unique_ptr<Component>> components;
     Transform* mTransform;
 
+    std::vector<CollisionListener> mCollisionListeners;    // en orden de AddComponent
+    uint8_t mListenerHooks = 0;                             // OR de los hooks de mCollisionListeners
+
     bool mActive = true;
     bool mParentActive = true;
     bool mAwoken = false;
     bool mStarted = false;
 
+    ActivationPriority mActivationPriority = ActivationPriority::Normal;
+
+    // Particion del mundo (Scene::EnableWorldPartition)
+    bool mStreamedOut = false;      // chunk suspendido: sin Update/FixedUpdate/Render
+    bool mPinned = false;           // nunca se suspende (jugador, camara, HUD...)
+    uint64_t mChunkKey = 0;
+    int32_t mChunkSlot = -1;        // indice en Chunk::objects (-1 = sin chunk)
+
+    // Nivel de detalle (Scene::EnableSimulationLod); los hijos siguen a la raiz
+    SimulationLod mLodTier = SimulationLod::Full;
+    bool mLodPinned = false;        // siempre a ritmo completo (jugador, jefes, HUD...)
+    uint32_t mLodPhase = 0;         // desfase del tick en Reduced (ID de la raiz)
+    float mLodScale = 1.f;          // pasos fijos que avanza en este (0 = no le toca)
+    uint32_t mLodPendingSteps = 0;  // pasos fijos saltados desde su ultimo FixedUpdate
+    float mLodPendingDt = 0.f;      // dt de frame acumulado desde su ultimo Update
+    bool mLodFrameTick = true;      // ha tenido Update este frame (corrutinas en Reduced)
+
 public:
     GameObject() noexcept;
 
@@ -144,6 +226,21 @@ public:
 
 	using ParentProp = PropertyRO<GameObject, GameObject*, &GameObject::GetParent>;
 	ParentProp parent{ this };
+
+    using ActivationPriorityProp = Property<GameObject, ActivationPriority, &GameObject::GetActivationPriority, &GameObject::SetActivationPriority>;
+    ActivationPriorityProp activationPriority{ this };
+
+    using StreamingPinnedProp = Property<GameObject, bool, &GameObject::IsStreamingPinned, &GameObject::SetStreamingPinned>;
+    StreamingPinnedProp streamingPinned{ this };
+
+    using StreamedOutProp = PropertyRO<GameObject, bool, &GameObject::IsStreamedOut>;
+    StreamedOutProp streamedOut{ this };
+
+    using SimulationLodPinnedProp = Property<GameObject, bool, &GameObject::IsSimulationLodPinned, &GameObject::SetSimulationLodPinned>;
+    SimulationLodPinnedProp simulationLodPinned{ this };
+
+    using SimulationLodProp = PropertyRO<GameObject, SimulationLod, &GameObject::GetSimulationLod>;
+    SimulationLodProp simulationLod{ this };
 };
 
 template<class T, class... Args>
@@ -169,12 +266,43 @@ T* GameObject::AddComponent(Args&&... args) {
     }
     else
     {
+        if constexpr (ListenerHooks_<T>() != 0)
+        {
+            mCollisionListeners.push_back({ raw, ListenerHooks_<T>() });
+            mListenerHooks |= ListenerHooks_<T>();
+        }
+
         raw->OnAddedToGameObject(mAwoken, mStarted);
     }
 
     return raw;
 }
 
+// Un hook cuenta si T lo overridea. &T::Hook tiene tipo Behaviour::* solo si nadie
+// lo ha redefinido; si T lo redeclara private/protected no es accesible desde aqui
+// y tambien cuenta (mejor un evento de mas que perder uno).
+template<class T>
+constexpr uint8_t GameObject::ListenerHooks_() noexcept
+{
+    if constexpr (!std::is_base_of_v<Behaviour, T>)
+    {
+        return 0;
+    }
+    else
+    {
+        using Hook = void (Behaviour::*)(const CollisionInfo2D&);
+
+        uint8_t hooks = 0;
+        if constexpr (!requires { { &T::OnCollisionEnter } -> std::same_as<Hook>; }) hooks |= kCollisionEnter;
+        if constexpr (!requires { { &T::OnCollisionStay } -> std::same_as<Hook>; }) hooks |= kCollisionStay;
+        if constexpr (!requires { { &T::OnCollisionExit } -> std::same_as<Hook>; }) hooks |= kCollisionExit;
+        if constexpr (!requires { { &T::OnTriggerEnter } -> std::same_as<Hook>; }) hooks |= kTriggerEnter;
+        if constexpr (!requires { { &T::OnTriggerStay } -> std::same_as<Hook>; }) hooks |= kTriggerStay;
+        if constexpr (!requires { { &T::OnTriggerExit } -> std::same_as<Hook>; }) hooks |= kTriggerExit;
+        return hooks;
+    }
+}
+
 template<class T>
 T* GameObject::GetComponent() noexcept {
     for (auto& c : components)
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <cstdint>
+
+#include "Singleton.h"
+
+// =========================
+// JobSystem
+// =========================
+//
+// Pool fijo de hilos de trabajo para paralelizar bucles internos del motor.
+// ParallelFor(n, job) ejecuta job(0..n-1) repartidos entre los workers y el hilo
+// que llama (que tambien trabaja) y vuelve cuando han terminado todos.
+// El orden de ejecucion NO es determinista: cada job debe escribir solo en su
+// propia salida (indexada por job) y el que llama las junta en orden.
+class JobSystem : public Singleton<JobSystem>
+{
+    friend class Singleton<JobSystem>;
+    friend class Engine;
+
+public:
+    struct Config
+    {
+        int workerThreads = 0;      // 0 = automatico (nucleos - 1), < 0 = sin workers
+    };
+
+    void ParallelFor(uint32_t jobCount, const std::function<void(uint32_t)>& job) noexcept;
+
+    // Hilos que pueden ejecutar jobs a la vez (workers + el que llama)
+    inline uint32_t GetThreadCount() const noexcept { return (uint32_t)mWorkers.size() + 1; }
+
+private:
+    JobSystem() = default;
+    ~JobSystem() { Shutdown(); }
+
+    bool Init(const Config& cfg) noexcept;
+    void Shutdown() noexcept;
+
+    void WorkerLoop_() noexcept;
+    void RunJobs_(const std::function<void(uint32_t)>& job, uint32_t jobCount) noexcept;
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+    JobSystem(JobSystem&&) = delete;
+    JobSystem& operator=(JobSystem&&) = delete;
+
+    std::vector<std::thread> mWorkers;
+
+    std::mutex mMutex;
+    std::condition_variable mWake;      // hay lote nuevo (o salir)
+    std::condition_variable mDone;      // un worker ha dejado el lote
+
+    const std::function<void(uint32_t)>* mJob = nullptr;   // lote en curso (nullptr = ninguno)
+    uint32_t mJobCount = 0;
+    std::atomic<uint32_t> mNext{ 0 };   // siguiente job a repartir
+    uint64_t mGeneration = 0;           // sube con cada lote
+    uint32_t mActive = 0;               // workers dentro del lote actual
+    bool mQuit = false;
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// =========================
+// Narrowphase por lotes
+// =========================
+//
+// Descarte conservador de pares candidatos sobre entradas SoA, 4 pares por
+// instruccion con SSE2 (x86/x64) y bucle escalar equivalente en el resto.
+// maybe[i] = 1 si el par PUEDE tocar; los que quedan pasan por el narrowphase
+// escalar de siempre, que es quien genera el contacto. El filtro tiene un margen
+// (kSlack) para no descartar nunca un par que el escalar aceptaria, asi el
+// resultado final es identico bit a bit con y sin SIMD.
+namespace narrow
+{
+    // Par circulo-circulo
+    struct CircleCircleBatch
+    {
+        std::vector<float> ax, ay, ar;
+        std::vector<float> bx, by, br;
+
+        void Clear() noexcept;
+        void Push(float cax, float cay, float ra, float cbx, float cby, float rb);
+        inline size_t Size() const noexcept { return ax.size(); }
+    };
+
+    // Par caja-circulo (la caja siempre primero). rot = (cos, sin)
+    struct BoxCircleBatch
+    {
+        std::vector<float> bx, by, hx, hy, c, s;
+        std::vector<float> cx, cy, r;
+
+        void Clear() noexcept;
+        void Push(float boxX, float boxY, float halfX, float halfY, float cosA, float sinA,
+            float circleX, float circleY, float radius);
+        inline size_t Size() const noexcept { return bx.size(); }
+    };
+
+    // Par caja-caja (SAT en los 4 ejes)
+    struct BoxBoxBatch
+    {
+        std::vector<float> ax, ay, ahx, ahy, ac, as;
+        std::vector<float> bx, by, bhx, bhy, bc, bs;
+
+        void Clear() noexcept;
+        void Push(float aX, float aY, float aHx, float aHy, float aCos, float aSin,
+            float bX, float bY, float bHx, float bHy, float bCos, float bSin);
+        inline size_t Size() const noexcept { return ax.size(); }
+    };
+
+    void Cull(const CircleCircleBatch& b, uint8_t* maybe) noexcept;
+    void Cull(const BoxCircleBatch& b, uint8_t* maybe) noexcept;
+    void Cull(const BoxBoxBatch& b, uint8_t* maybe) noexcept;
+
+    // true si esta build usa el camino SSE2
+    bool HasSimd() noexcept;
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "GameObject.h"
+
+class Collider2D;
+class RigidBody2D;
+
+// =========================
+// PairTable
+// =========================
+//
+// Tabla persistente de pares en contacto (clave = MakeKey_ de los dos IDs):
+// - Direccionamiento abierto con sondeo lineal, capacidad potencia de 2 y
+//   borrado por desplazamiento hacia atras (sin tombstones).
+// - Los registros sobreviven entre pasos: no se limpia ni se rellena cada
+//   frame, solo se sella con el numero de pasada (stamp) en que se tocaron.
+//   Enter/Stay/Exit salen de comparar stamps con el estado del ultimo dispatch.
+// - Cada par guarda los impulsos acumulados del ultimo paso para que el solver
+//   arranque desde ellos (warm starting).
+class PairTable
+{
+public:
+    struct Pair
+    {
+        uint64_t key = 0;               // 0 = slot libre
+
+        GameObject* a = nullptr;
+        GameObject* b = nullptr;
+        Collider2D* colA = nullptr;
+        Collider2D* colB = nullptr;
+        RigidBody2D* bodyA = nullptr;
+        RigidBody2D* bodyB = nullptr;
+        bool isTriggerPair = false;
+
+        bool touching = false;          // en contacto en el ultimo dispatch
+        uint32_t stamp = 0;             // ultima pasada de deteccion que lo toco
+
+        ContactPoint contact{};
+
+        // Cache para el solver (warm starting): impulso normal acumulado de cada
+        // punto de manifold del ultimo paso. El par es por GameObject, asi que la
+        // clave incluye los colliders ademas del id de feature del punto. Con mas
+        // puntos que slots (varios colliders del objeto) se guardan los primeros.
+        struct CachedImpulse
+        {
+            const Collider2D* colA = nullptr;
+            const Collider2D* colB = nullptr;
+            uint32_t id = 0;
+            float normalImpulse = 0.f;
+        };
+
+        static constexpr uint32_t kMaxCachedImpulses = 4;
+        CachedImpulse impulses[kMaxCachedImpulses]{};
+        uint32_t impulseCount = 0;
+        uint32_t impulseStamp = 0;      // pasada en que se guardaron
+
+        inline float FindImpulse(const Collider2D* ca, const Collider2D* cb, uint32_t id) const noexcept
+        {
+            for (uint32_t i = 0; i < impulseCount; ++i)
+                if (impulses[i].id == id && impulses[i].colA == ca && impulses[i].colB == cb)
+                    return impulses[i].normalImpulse;
+            return 0.f;
+        }
+
+        // La primera escritura de cada pasada descarta lo del paso anterior
+        inline void StoreImpulse(uint32_t passStamp, const Collider2D* ca, const Collider2D* cb, uint32_t id, float impulse) noexcept
+        {
+            if (impulseStamp != passStamp) { impulseCount = 0; impulseStamp = passStamp; }
+            if (impulseCount < kMaxCachedImpulses) impulses[impulseCount++] = { ca, cb, id, impulse };
+        }
+    };
+
+    PairTable() noexcept = default;
+
+    // Busca o inserta (inserted = true si es nuevo). La referencia es valida
+    // hasta la siguiente insercion.
+    Pair& Touch(uint64_t key, bool& inserted);
+
+    Pair* Find(uint64_t key) noexcept;
+    const Pair* Find(uint64_t key) const noexcept;
+    void Erase(uint64_t key) noexcept;
+    void Clear() noexcept;
+
+    inline size_t Size() const noexcept { return mCount; }
+    inline size_t Capacity() const noexcept { return mSlots.size(); }
+
+    // callback(Pair&) sobre los slots ocupados. No insertar ni borrar dentro.
+    template<class F>
+    void ForEach(F&& callback)
+    {
+        for (Pair& p : mSlots)
+            if (p.key != 0) callback(p);
+    }
+
+private:
+    static inline size_t Hash_(uint64_t k) noexcept
+    {
+        k ^= k >> 33;
+        k *= 0xff51afd7ed558ccdULL;
+        k ^= k >> 33;
+        return (size_t)k;
+    }
+
+    size_t FindSlot_(uint64_t key) const noexcept;   // SIZE_MAX si no esta
+    void Grow_();
+
+    std::vector<Pair> mSlots;
+    size_t mCount = 0;
+};
@@ -9,12 +9,15 @@
 #include "Singleton.h"
 #include "BaseTypes.h"
 #include "RigidBody2D.h"
+#include "PairTable.h"
 #include "Engine.h"
 
 struct NarrowContact;
 
 class CollisionManager;
+class Transform;
 class SceneManager;
+class Scene;
 
 class PhysicsManager : public Singleton<PhysicsManager>
 {
@@ -22,6 +25,8 @@ class PhysicsManager : public Singleton<PhysicsManager>
     friend class Engine;
     friend class SceneManager;
     friend class RigidBody2D;
+    friend class Scene;
+    friend class CollisionManager;
 
     struct Config
     {
@@ -30,6 +35,13 @@ class PhysicsManager : public Singleton<PhysicsManager>
         float penetrationPercent = 0.8f;
         int maxSubsteps = 8;
         float ccdMinSizeFactor = 0.5f;
+        bool ccdSubstepping = false;
+        int velocityIterations = 4;
+        float solverTolerance = 1e-3f;
+        bool enableSleeping = true;
+        float sleepLinearVelocity = 0.05f;
+        float sleepAngularVelocity = 0.05f;
+        float timeToSleep = 0.5f;
     };
 
 private:
@@ -43,15 +55,28 @@ private:
         penetrationPercent = cfg.penetrationPercent;
         maxSubsteps = cfg.maxSubsteps;
         ccdMinSizeFactor = cfg.ccdMinSizeFactor;
+        ccdSubstepping = cfg.ccdSubstepping;
+        SetVelocityIterations(cfg.velocityIterations);
+        SetSolverTolerance(cfg.solverTolerance);
+        enableSleeping = cfg.enableSleeping;
+        SetSleepLinearVelocity(cfg.sleepLinearVelocity);
+        SetSleepAngularVelocity(cfg.sleepAngularVelocity);
+        SetTimeToSleep(cfg.timeToSleep);
 
-        mBodies.clear(); return true; 
+        mWorld = World{}; mSuspendedWorlds.clear(); return true; 
     }
-    void Shutdown() noexcept { mBodies.clear(); }
+    void Shutdown() noexcept { mWorld = World{}; mSuspendedWorlds.clear(); }
 
     void RegisterBody(RigidBody2D* b) noexcept;
     void RemoveBody(RigidBody2D* b) noexcept;
     void SetBodyActive(RigidBody2D* b, bool active) noexcept;
 
+    // Mundos por escena (ver CollisionManager::SuspendWorld)
+    void ClearAll() noexcept { mWorld = World{}; }
+    void SuspendWorld(const Scene* scene) noexcept;
+    bool ResumeWorld(const Scene* scene) noexcept;
+    void DiscardWorld(const Scene* scene) noexcept;
+
     // Llamar desde Engine::DoFixedUpdates_
     void Step(float fixedDt) noexcept;
 
@@ -62,31 +87,225 @@ private:
     float penetrationSlop = 0.01f;
     float penetrationPercent = 0.8f;
 
-    // Continuous: substeps
+    // Continuous: cada cuerpo Continuous que en un substep avanza mas de
+    // ccdMinSizeFactor * su tamano se barre contra el mundo (tiempo de impacto).
+    // Con ccdSubstepping, ademas, el paso entero se trocea (hasta maxSubsteps)
+    // segun el cuerpo Continuous mas rapido, como antes.
     int maxSubsteps = 8;
-    float ccdMinSizeFactor = 0.5f; // cuanto menor, ms substeps (ms seguro)
+    float ccdMinSizeFactor = 0.5f; // cuanto menor, ms cuerpos se barren (ms seguro)
+    bool ccdSubstepping = false;
+
+    // Iteraciones del solver de velocidades por substep
+    int velocityIterations = 4;
+    // Corte anticipado: impulso (N*s) por debajo del cual se da por convergido (0 = nunca)
+    float solverTolerance = 1e-3f;
+
+    // Sueno: una isla (cuerpos dinamicos unidos por contactos) se duerme entera cuando
+    // todos sus cuerpos llevan timeToSleep por debajo de las dos velocidades
+    bool enableSleeping = true;
+    float sleepLinearVelocity = 0.05f;     // unidades/s
+    float sleepAngularVelocity = 0.05f;    // rad/s
+    float timeToSleep = 0.5f;              // s
 
     inline Vec2 GetGravity() const noexcept { return gravity; }
     inline float GetPenetrationSlop() const noexcept { return penetrationSlop; }
     inline float GetPenetrationPercent() const noexcept { return penetrationPercent; }
     inline int   GetMaxSubsteps() const noexcept { return maxSubsteps; }
     inline float GetCCDMinSizeFactor() const noexcept { return ccdMinSizeFactor; }
+    inline bool  GetCCDSubstepping() const noexcept { return ccdSubstepping; }
+    inline int   GetVelocityIterations() const noexcept { return velocityIterations; }
+    inline float GetSolverTolerance() const noexcept { return solverTolerance; }
+    inline bool  GetEnableSleeping() const noexcept { return enableSleeping; }
+    inline float GetSleepLinearVelocity() const noexcept { return sleepLinearVelocity; }
+    inline float GetSleepAngularVelocity() const noexcept { return sleepAngularVelocity; }
+    inline float GetTimeToSleep() const noexcept { return timeToSleep; }
 
     inline void SetGravity(const Vec2 g) noexcept { gravity = g; }
     inline void SetPenetrationSlop(float slop) noexcept { penetrationSlop = slop; }
     inline void SetPenetrationPercent(float percent) noexcept { penetrationPercent = percent; }
     inline void SetMaxSubsteps(int substeps) noexcept { maxSubsteps = (substeps < 1) ? 1 : substeps; }
     inline void SetCCDMinSizeFactor(float factor) noexcept { ccdMinSizeFactor = (factor < 0.0f) ? 0.0f : factor; }
+    inline void SetCCDSubstepping(bool enable) noexcept { ccdSubstepping = enable; }
+    inline void SetVelocityIterations(int iters) noexcept { velocityIterations = (iters < 1) ? 1 : iters; }
+    inline void SetSolverTolerance(float tol) noexcept { solverTolerance = (tol < 0.0f) ? 0.0f : tol; }
+    void SetEnableSleeping(bool enable) noexcept;
+    inline void SetSleepLinearVelocity(float v) noexcept { sleepLinearVelocity = (v < 0.0f) ? 0.0f : v; }
+    inline void SetSleepAngularVelocity(float w) noexcept { sleepAngularVelocity = (w < 0.0f) ? 0.0f : w; }
+    inline void SetTimeToSleep(float t) noexcept { timeToSleep = (t < 0.0f) ? 0.0f : t; }
 
 private:
-    std::unordered_map<RigidBody2D*, bool> mBodies;
+    // Cuerpos en arrays densos (SoA) por orden de registro; RigidBody2D::bodyIndex_ es
+    // su fila. Step copia aqui el estado una vez por paso fijo (GatherBodies_), los
+    // substeps integran y resuelven sobre los arrays sin tocar ningun Transform (la
+    // cache de colliders lee la pose de aqui, ver BodyPose_) y las posiciones vuelven
+    // a los Transform una sola vez al final del paso (WriteBackBodies_).
+    struct BodyStore
+    {
+        std::vector<RigidBody2D*> rb;
+        std::vector<Transform*>   tr;
+        std::vector<uint8_t>      active;
+
+        // Estado
+        std::vector<float> px, py, rot;         // rot en grados, como Transform
+        std::vector<float> px0, py0, rot0;      // Transform al recoger (BodyPose_ mueve colliders hijos con el delta)
+        std::vector<float> vx, vy, w;
+        std::vector<float> sleepTime;           // sueno al final del paso (UpdateSleep_)
+        std::vector<uint8_t> sleeping;
+        std::vector<uint32_t> sleepIsland;      // isla con la que se durmio (0 = despierto)
+        std::vector<float> forceX, forceY, accelX, accelY;  // acumuladores del RigidBody2D que quedan
+        std::vector<float> torque, angularAccel;            // al final del paso (saltados por LOD)
+        std::vector<float> ax, ay, aw;          // acumuladores como aceleracion (F/m + accel), solo el primer substep
+
+        // Coeficientes (RefreshBody_)
+        std::vector<float> invM, invI;          // 0 si no es dinamico
+        std::vector<float> gravityScale;
+        std::vector<float> linearDamping, angularDamping;   // 0 en cinematicos
+        std::vector<float> mx, my, mw;          // 0 en los ejes congelados
+        std::vector<float> dyn;                 // 1 = dinamico despierto que avanza este paso: fuerzas y gravedad
+        std::vector<float> move;                // 1 = se integra su pose: dinamico despierto o cinematico
+        std::vector<float> solve;               // 1 = dinamico despierto: entra al solver con su masa (aunque el LOD lo salte)
+        std::vector<float> lod;                 // pasos fijos que avanza en este (GameObject LOD; 0 = quieto)
 
-    inline Vec2 ColliderCenterWorld_(const Collider2D* c) noexcept;
+        inline uint32_t Size() const noexcept { return (uint32_t)rb.size(); }
+        void Resize(size_t n);
+        void CopyRow(size_t to, size_t from) noexcept;
+    };
+
+    // Estado fisico de una escena
+    struct World
+    {
+        BodyStore bodies;
+        uint64_t version = 0;                   // cambia al registrar o quitar cuerpos (valida los State)
+    };
+
+    World mWorld;                                           // mundo de la escena activa
+    std::unordered_map<const Scene*, World> mSuspendedWorlds;
+    uint64_t mVersionCounter = 0;
+    bool mInStep = false;                                   // entre GatherBodies_ y WriteBackBodies_
 
+    inline bool Owns_(const RigidBody2D* rb) const noexcept
+    {
+        return rb && rb->bodyIndex_ < mWorld.bodies.Size() && mWorld.bodies.rb[rb->bodyIndex_] == rb;
+    }
+
+    void RefreshBody_(uint32_t i) noexcept;
+    void WakeBody_(RigidBody2D* rb) noexcept;
+    void GatherBodies_() noexcept;
+    void WriteBackBodies_() noexcept;
+    // Pose en mundo de un Transform colgado de rb con el estado del substep (false fuera de Step)
+    bool BodyPose_(const RigidBody2D* rb, const Transform* tr, Vec3& pos, float& rotZ) const noexcept;
+
+    // Cuerpos Continuous despiertos del paso (con su collider y tamano caracteristico)
+    struct CcdBody
+    {
+        uint32_t body = 0;
+        Collider2D* col = nullptr;
+        float minMove = 0.f;            // desplazamiento por substep a partir del cual se barre
+        Vec2 start{ 0.f, 0.f };         // posicion antes de integrar el substep
+        bool lodOnly = false;           // Discrete en un tick de LOD: se barre, pero no sube los substeps
+    };
+    std::vector<CcdBody> mCcdBodies;
+
+    void GatherContinuous_() noexcept;
     int ComputeSubsteps_(float dt) noexcept;
     void Integrate_(float dt) noexcept;
-    void SolveContacts_(const std::vector<NarrowContact>& contacts, float dt) noexcept;
-    void PositionalCorrection_(const std::vector<NarrowContact>& contacts) noexcept;
+    void SweepContinuous_() noexcept;
+    // Solver de velocidades con impulsos acumulados. Una vez por substep se construyen
+    // filas planas (una por punto de manifold) con todo lo que no cambia entre
+    // iteraciones; las velocidades viven en mSolverBodies mientras se resuelve y se
+    // escriben en el BodyStore al final. Se arranca con los impulsos del paso
+    // anterior (warm starting), cada iteracion solo corrige el acumulado (nunca < 0)
+    // y se para en cuanto el mayor cambio de impulso baja de solverTolerance.
+    //
+    // Las filas se agrupan por islas del substep (cuerpos movibles conectados; los
+    // estaticos, cinematicos y dormidos las separan) y cada isla se resuelve entera
+    // en un job, con su propia parada temprana. La correccion de posicion se acumula
+    // en dp y se aplica despues en serie.
+    struct SolverBody
+    {
+        RigidBody2D* rb = nullptr;      // nullptr = sin cuerpo (indice 0)
+        uint32_t body = UINT32_MAX;     // fila del BodyStore (UINT32_MAX = no esta)
+        Vec2 v{ 0.f, 0.f };
+        float w = 0.f;
+        float invM = 0.f;               // 0 si no es dinamico
+        float invI = 0.f;               // 0 si ademas tiene FreezeRot
+        Vec2 linearMask{ 1.f, 1.f };    // 0 en los ejes con FreezePos
+        Vec2 dp{ 0.f, 0.f };            // correccion de posicion acumulada
+        uint32_t island = 0;            // solo valido en la raiz (BuildSolverIslands_)
+    };
+
+    struct ContactRow
+    {
+        uint32_t bodyA = 0;
+        uint32_t bodyB = 0;
+        PairTable::Pair* pair = nullptr;
+        const Collider2D* colA = nullptr;
+        const Collider2D* colB = nullptr;
+        uint32_t id = 0;                // feature del punto (clave del warm starting)
+
+        Vec2 n{ 0.f, 0.f };             // A->B
+        Vec2 rA{ 0.f, 0.f };            // centro -> punto
+        Vec2 rB{ 0.f, 0.f };
+        float rnA = 0.f;                // Cross(rA, n)
+        float rnB = 0.f;
+        float normalMass = 0.f;         // 1 / masa efectiva
+        float bias = 0.f;               // Baumgarte
+        float restitution = 0.f;        // velocidad de rebote (0 si llega despacio)
+        float normalImpulse = 0.f;      // acumulado
+    };
+
+    // Una por contacto (no por punto): empuja con la penetracion maxima
+    struct PositionRow
+    {
+        uint32_t bodyA = 0;
+        uint32_t bodyB = 0;
+        Vec2 n{ 0.f, 0.f };             // A->B
+        float penetration = 0.f;
+    };
+
+    std::vector<SolverBody> mSolverBodies;
+    std::vector<ContactRow> mContactRows;
+    std::vector<PositionRow> mPositionRows;
+    uint32_t mSolverStamp = 0;          // pasada de PrepareContacts_ (ver RigidBody2D::solverStamp_)
+
+    // Islas del substep: filas [start[i], start[i+1]) de cada isla
+    std::vector<uint32_t> mSolverParent;
+    std::vector<uint32_t> mRowIsland;
+    std::vector<uint32_t> mPositionIsland;
+    std::vector<uint32_t> mIslandRowStart;
+    std::vector<uint32_t> mIslandPositionStart;
+    std::vector<uint32_t> mIslandCursor;
+    std::vector<ContactRow> mContactRowScratch;
+    std::vector<PositionRow> mPositionRowScratch;
+    std::vector<uint32_t> mSolverJobStart;  // islas [start[j], start[j+1]) del job j
+    std::vector<int> mSolverJobIters;       // salida por job: mas iteraciones de sus islas
+
+    uint32_t SolverBodyOf_(RigidBody2D* rb) noexcept;
+    void PrepareContacts_(const std::vector<NarrowContact>& contacts, float dt) noexcept;
+    void BuildSolverIslands_() noexcept;
+    void ApplyImpulse_(const ContactRow& row, float j) noexcept;
+    void WarmStart_(uint32_t begin, uint32_t end) noexcept;
+    float SolveContacts_(uint32_t begin, uint32_t end) noexcept;    // devuelve el mayor |cambio de impulso|
+    void PositionalCorrection_(uint32_t begin, uint32_t end) noexcept;
+    int SolveIsland_(uint32_t island) noexcept;                     // devuelve las iteraciones usadas
+    void SolveIslands_() noexcept;
+    void FinishContacts_() noexcept;
+
+    // Islas por union-find sobre los contactos del ultimo substep; los dormidos no se
+    // prueban y se unen por la isla con la que se durmieron (BodyStore::sleepIsland).
+    // Se duermen y se despiertan enteras. Una vez por paso fijo.
+    std::vector<RigidBody2D*> mIslandBodies;
+    std::vector<uint32_t> mIslandParent;
+    std::vector<float> mIslandMinSleep;
+    std::vector<uint8_t> mIslandAwake;
+    std::vector<uint32_t> mIslandSize;
+    std::vector<uint32_t> mIslandSleepId;
+    std::unordered_map<uint32_t, uint32_t> mSleepIslandFirst;  // id de isla dormida -> primer cuerpo
+    uint32_t mSleepIslandCounter = 0;
+
+    static bool IsMoving_(const RigidBody2D* rb) noexcept;
+    static uint32_t FindRoot_(std::vector<uint32_t>& parent, uint32_t i) noexcept;
+    void UpdateSleep_(float dt, const std::vector<NarrowContact>& contacts) noexcept;
 
     // helpers 2D
     static inline float Cross(const Vec2& a, const Vec2& b) noexcept { return a.x * b.y - a.y * b.x; }
@@ -101,10 +320,46 @@ private:
     double solveTimeSec = 0.0;
 
     int nSubstepsThisFrame = 0;
-    int solverIterations = 0;
+    int solverIterations = 0;          // iteraciones ejecutadas (suma de substeps; por substep, la isla que mas)
+    int nSolverIslands = 0;            // islas del solver en el ultimo substep
+    int nSolverJobs = 0;               // jobs en que se repartieron
+    int nCcdSweeps = 0;                // barridos de cuerpos Continuous (suma de substeps)
+    int nCcdHits = 0;                  // barridos que han recortado el movimiento
+    int nSleepingBodies = 0;
+    int nIslands = 0;                  // islas con mas de un cuerpo
     std::uint64_t nContactsProcessedThisFrame = 0;
 
 public:
+    // Estado de la simulacion para rollback / rebobinado: pose, velocidades, sueno y
+    // fuerzas acumuladas de todos los cuerpos y la tabla de pares (contactos e impulsos del warm starting),
+    // en buffers contiguos que se reutilizan entre guardados.
+    class State
+    {
+        friend class PhysicsManager;
+
+        uint64_t bodiesVersion = 0;
+        uint64_t collidersVersion = 0;
+        std::vector<float> px, py, rot, vx, vy, w, sleepTime;
+        std::vector<uint8_t> sleeping;
+        std::vector<uint32_t> sleepIsland;
+        std::vector<float> forceX, forceY, accelX, accelY, torque, angularAccel;
+        PairTable pairs;
+        uint32_t collisionStamp = 0;
+        bool valid = false;
+
+    public:
+        bool IsValid() const noexcept { return valid; }
+    };
+
+    // Guarda el estado del final del ultimo Step: son copias de arrays, sin recorrer
+    // objetos. Lo que se toque a mano despues del paso (Transform, velocity, fuerzas)
+    // no entra. Las fuerzas acumuladas si: al final del paso solo quedan en los
+    // cuerpos que el LOD de la escena no ha hecho avanzar, y se aplican en su tick.
+    bool SaveState(State& out) noexcept;
+    // Vuelve al estado guardado y lo escribe en los Transform y RigidBody2D. Falla
+    // (sin tocar nada) si desde el guardado se ha registrado o quitado algun cuerpo
+    // o collider, o si es de otra escena.
+    bool RestoreState(const State& in) noexcept;
 
     using GravityProp = Property<PhysicsManager, Vec2,
         &PhysicsManager::GetGravity,
@@ -126,6 +381,18 @@ public:
         &PhysicsManager::GetCCDMinSizeFactor,
         &PhysicsManager::SetCCDMinSizeFactor>;
 
+    using CCDSubsteppingProp = Property<PhysicsManager, bool,
+        &PhysicsManager::GetCCDSubstepping,
+        &PhysicsManager::SetCCDSubstepping>;
+
+    using VelocityIterationsProp = Property<PhysicsManager, int,
+        &PhysicsManager::GetVelocityIterations,
+        &PhysicsManager::SetVelocityIterations>;
+
+    using SolverToleranceProp = Property<PhysicsManager, float,
+        &PhysicsManager::GetSolverTolerance,
+        &PhysicsManager::SetSolverTolerance>;
+
     GravityProp gravityProp{ this };
 
     PenetrationSlopProp penetrationSlopProp{ this };
@@ -133,4 +400,29 @@ public:
 
     MaxSubstepsProp maxSubstepsProp{ this };
     CCDMinSizeFactorProp ccdMinSizeFactorProp{ this };
+    CCDSubsteppingProp ccdSubsteppingProp{ this };
+
+    VelocityIterationsProp velocityIterationsProp{ this };
+    SolverToleranceProp solverToleranceProp{ this };
+
+    using EnableSleepingProp = Property<PhysicsManager, bool,
+        &PhysicsManager::GetEnableSleeping,
+        &PhysicsManager::SetEnableSleeping>;
+
+    using SleepLinearVelocityProp = Property<PhysicsManager, float,
+        &PhysicsManager::GetSleepLinearVelocity,
+        &PhysicsManager::SetSleepLinearVelocity>;
+
+    using SleepAngularVelocityProp = Property<PhysicsManager, float,
+        &PhysicsManager::GetSleepAngularVelocity,
+        &PhysicsManager::SetSleepAngularVelocity>;
+
+    using TimeToSleepProp = Property<PhysicsManager, float,
+        &PhysicsManager::GetTimeToSleep,
+        &PhysicsManager::SetTimeToSleep>;
+
+    EnableSleepingProp enableSleepingProp{ this };
+    SleepLinearVelocityProp sleepLinearVelocityProp{ this };
+    SleepAngularVelocityProp sleepAngularVelocityProp{ this };
+    TimeToSleepProp timeToSleepProp{ this };
 };
\ No newline at end of file
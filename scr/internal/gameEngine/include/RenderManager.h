@@ -13,6 +13,7 @@ class Camera2D;
 class WindowManager;
 class Collider2D;
 class SpriteRenderer;
+class Tilemap;
 class UIManager;
 class AssetManager;
 
@@ -22,6 +23,7 @@ class RenderManager : public Singleton<RenderManager>
     friend class Scene;
     friend class Collider2D;
 	friend class SpriteRenderer;
+    friend class Tilemap;
 	friend class UIManager;
 	friend class AssetManager;
     friend class Engine;
@@ -15,6 +15,7 @@ class RigidBody2D : public Behaviour
 {
     friend class PhysicsManager;
     friend class GameObject;
+    friend class SceneSnapshot;
 
 public:
     enum class BodyType : uint8_t { Static, Dynamic, Kinematic };
@@ -54,6 +55,20 @@ private:
     float accumTorque_ = 0.f;             // torque (Force)
     float accumAngularAccel_ = 0.f;       // rad/s^2 (Acceleration)
 
+    // Fila en el BodyStore del PhysicsManager (UINT32_MAX = sin registrar)
+    uint32_t bodyIndex_ = UINT32_MAX;
+
+    // Indice en los cuerpos del solver, valido si solverStamp_ es la pasada actual
+    uint32_t solverIndex_ = 0;
+    uint32_t solverStamp_ = 0;
+
+    // Sueno: un cuerpo dormido no se integra, no actualiza su broadphase ni entra
+    // en el solver hasta que algo lo despierta (contacto, fuerza, velocidad)
+    bool allowSleep_ = true;
+    bool sleeping_ = false;
+    float sleepTime_ = 0.f;             // tiempo seguido por debajo de los umbrales
+    uint32_t islandIndex_ = 0;          // union-find de islas (PhysicsManager)
+
     // util
     float InvMass_() const noexcept {
         if (bodyType_ != BodyType::Dynamic) return 0.f;
@@ -69,7 +84,7 @@ private:
     }
 
     BodyType GetBodyType() const noexcept { return bodyType_; }
-    void SetBodyType(BodyType t) noexcept { bodyType_ = t; }
+    void SetBodyType(BodyType t) noexcept;
 
     CollisionDetection GetCollisionDetection() const noexcept { return collisionDetection_; }
     void SetCollisionDetection(CollisionDetection d) noexcept { collisionDetection_ = d; }
@@ -96,10 +111,13 @@ private:
     void SetConstraints(Constraints c) noexcept { constraints_ = c; }
 
     Vec2 GetVelocity() const noexcept { return velocity_; }
-    void SetVelocity(Vec2 v) noexcept { velocity_ = v; }
+    void SetVelocity(Vec2 v) noexcept { velocity_ = v; if (v.x != 0.f || v.y != 0.f) WakeUp(); }
 
     float GetAngularVelocity() const noexcept { return angularVelocity_; }
-    void SetAngularVelocity(float w) noexcept { angularVelocity_ = w; }
+    void SetAngularVelocity(float w) noexcept { angularVelocity_ = w; if (w != 0.f) WakeUp(); }
+
+    bool GetAllowSleep() const noexcept { return allowSleep_; }
+    void SetAllowSleep(bool a) noexcept { allowSleep_ = a; if (!a) WakeUp(); }
 
 public:
     RigidBody2D() = default;
@@ -110,6 +128,7 @@ public:
         if (!mAwoken || !mEnabled) return;
         if (!gameObject->activeInHierarchy) return;
         if (bodyType_ == BodyType::Static) return;
+        if (f.x != 0.f || f.y != 0.f) WakeUp();
 
         switch (mode)
         {
@@ -125,6 +144,7 @@ public:
         if (!mAwoken || !mEnabled) return;
         if (!gameObject->activeInHierarchy) return;
         if (bodyType_ == BodyType::Static) return;
+        if (t != 0.f) WakeUp();
 
         switch (mode)
         {
@@ -135,6 +155,28 @@ public:
         }
     }
 
+    // Tambien despierta a su isla en el siguiente paso (lo que toca)
+    void WakeUp() noexcept {
+        if (!sleeping_) return;
+        sleeping_ = false;
+        sleepTime_ = 0.f;
+    }
+
+    // Solo dinamicos con allowSleep. Se queda quieto hasta que lo despierten.
+    // Si se mueve a mano su Transform mientras duerme, hay que llamar a WakeUp().
+    void Sleep() noexcept {
+        if (bodyType_ != BodyType::Dynamic || !allowSleep_) return;
+        sleeping_ = true;
+        velocity_ = { 0,0 };
+        angularVelocity_ = 0.f;
+        accumForce_ = { 0,0 };
+        accumAccel_ = { 0,0 };
+        accumTorque_ = 0.f;
+        accumAngularAccel_ = 0.f;
+    }
+
+    bool IsSleeping() const noexcept { return sleeping_; }
+
     void ClearForces() noexcept {
         if (!mAwoken || !mEnabled) return;
         if (!gameObject->activeInHierarchy) return;
@@ -215,6 +257,12 @@ public:
 
     AngularVelocityProp angularVelocity{ this };
 
+    using AllowSleepProp = Property<RigidBody2D, bool,
+        &RigidBody2D::GetAllowSleep,
+        &RigidBody2D::SetAllowSleep>;
+
+    AllowSleepProp allowSleep{ this };
+
 protected:
     bool IsUnique() const noexcept override { return kUnique; }
 
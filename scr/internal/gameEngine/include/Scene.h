@@ -6,6 +6,7 @@
 #include <unordered_map>
 
 #include "BaseTypes.h"
+#include "Coroutine.h"
 #include "SceneManager.h"
 #include "Engine.h"
 
@@ -20,10 +21,20 @@ class GameObject;
 using EntityID = uint32_t;
 using InstanceBuilder = std::function<void(GameObject&, Scene&)>;
 
+// Nivel de detalle de la simulacion de un objeto (Scene::EnableSimulationLod).
+//  - Full:    FixedUpdate, Update, fisica y corrutinas en cada paso.
+//  - Reduced: uno de cada N pasos / frames, con el dt acumulado; sus corrutinas
+//             solo se reanudan en esos ticks.
+//  - Frozen:  nada, ni corrutinas (el tiempo no corre para el objeto).
+enum class SimulationLod : uint8_t { Full, Reduced, Frozen };
+
 class Scene
 {
 	friend class SceneManager;
     friend class Engine;
+    friend class SceneSnapshot;
+    friend class Behaviour;
+    friend class GameObject;
 
 private:
     Scene() noexcept;
@@ -52,10 +63,42 @@ private:
     inline CollisionManager* GetCollision() const noexcept { return mCollision; }
 
     void FlushDestroyQueue();
-    void ProcessNewObjects();
+    void ProcessNewObjects();   // reparte Awake/Start segun el presupuesto del SceneManager
+    bool DefersActivation_(const GameObject* go) const noexcept;
 
     void CollectDescendants_(GameObject* root, std::vector<EntityID>& out);
 
+    // --- Particion del mundo (chunks alrededor de la camara) ---
+    struct Chunk
+    {
+        std::vector<GameObject*> objects;   // solo objetos raiz; los hijos siguen al padre
+        std::vector<uint8_t> evicted;       // snapshot de los objetos expulsados de memoria
+        float suspendedTime = 0.f;
+        bool active = true;
+    };
+
+    static inline uint64_t ChunkKey_(int cx, int cy) noexcept
+    {
+        return ((uint64_t)(uint32_t)cx << 32) | (uint64_t)(uint32_t)cy;
+    }
+
+    uint64_t ChunkKeyOf_(const GameObject* go) const noexcept;
+    bool ChunkInRange_(uint64_t key) const noexcept;
+
+    void UpdatePartition_(float dt) noexcept;
+    void PartitionTouch_(GameObject* go) noexcept;
+    void PartitionInsert_(GameObject* go, uint64_t key) noexcept;
+    void PartitionRemove_(GameObject* go) noexcept;
+    void SetChunkActive_(Chunk& chunk, bool active) noexcept;
+    void SetStreamedOut_(GameObject* go, bool out) noexcept;
+    void EvictChunk_(Chunk& chunk) noexcept;
+
+    // --- Nivel de detalle de la simulacion (alrededor de la camara) ---
+    void UpdateSimulationLod_() noexcept;
+    void ApplySimulationLod_(GameObject* go, SimulationLod tier, uint32_t phase) noexcept;
+    float SimulationLodFrameDt_(GameObject* go, float dt) noexcept;
+    void ResumeHeldCoroutines_(GameObject* go) noexcept;
+
     friend class SceneManager;
     bool mStarted = false;
 
@@ -64,12 +107,31 @@ private:
     SoundManager* mSound = nullptr;
     CollisionManager* mCollision = nullptr;
 
+    // Declarado antes que mEntities: sobrevive a los Behaviours que lo usan
+    CoroutineScheduler mCoroutines;
+
     EntityID mNextID = 1;
     std::vector<std::unique_ptr<GameObject>> mEntities;
     std::vector<EntityID> mDestroyQueue;
     std::vector<GameObject*> mNew;
     std::vector<GameObject*> mUninitialized;
 
+    bool mPartitionEnabled = false;
+    float mChunkSize = 0.f;
+    float mChunkRadius = 0.f;
+    float mEvictAfter = 0.f;
+    int mRangeMinX = 0, mRangeMinY = 0, mRangeMaxX = -1, mRangeMaxY = -1;
+    std::unordered_map<uint64_t, Chunk> mChunks;
+    std::vector<GameObject*> mPartitionPending;     // nuevos, reparentados o con pin cambiado
+
+    bool mLodEnabled = false;
+    float mLodMargin = 0.f;
+    float mLodFreezeDistance = 0.f;     // 0 = nunca se congela
+    uint32_t mLodInterval = 1;
+    uint32_t mLodStep = 0;              // pasos fijos desde EnableSimulationLod
+    uint32_t mLodFrame = 0;             // frames desde EnableSimulationLod
+    uint32_t mLodCounts[3] = { 0, 0, 0 };   // objetos por nivel en el ultimo paso fijo
+
     std::unordered_map<EntityID, GameObject*> mById;
     std::unordered_map<std::string, GameObject*> mByName;
 
@@ -97,6 +159,29 @@ public:
     GameObject* Find(EntityID id) noexcept;
     GameObject* Find(const std::string& name) noexcept;
 
+    // Particion del mundo (opt-in). Los objetos raiz se agrupan en chunks de
+    // chunkSize x chunkSize; los chunks a mas de activeRadius del viewRect de la
+    // camara se suspenden (sin Update/FixedUpdate, colliders y bodies inactivos, y
+    // sus corrutinas aparcadas hasta que vuelven a entrar en rango).
+    // Con evictAfterSeconds > 0, un chunk suspendido ese tiempo se guarda como
+    // snapshot y sus objetos se destruyen; se recrean al volver a entrar en rango
+    // (solo sobreviven los scripts registrados en SceneSnapshot y cambian los IDs).
+    void EnableWorldPartition(float chunkSize, float activeRadius, float evictAfterSeconds = 0.f) noexcept;
+    void DisableWorldPartition() noexcept;
+
+    // Nivel de detalle de la simulacion (opt-in). Cada objeto raiz se mide contra el
+    // viewRect de la camara (con sus hijos): a mas de margin, FixedUpdate, Update y su
+    // fisica corren uno de cada reducedInterval pasos fijos / frames con el dt
+    // acumulado (Reduced, repartidos por ID); a mas de freezeDistance (0 = nunca) no
+    // corren (Frozen). Se mide la posicion del Transform raiz: los objetos grandes
+    // (Tilemap...) o que deben ir siempre a ritmo completo usan simulationLodPinned.
+    void EnableSimulationLod(float margin, int reducedInterval, float freezeDistance = 0.f) noexcept;
+    void DisableSimulationLod() noexcept;
+
+    // Snapshot binario (ver SceneSnapshot.h). Load anade los objetos a esta escena.
+    bool SaveSnapshot(const std::string& path) const noexcept;
+    bool LoadSnapshot(const std::string& path) noexcept;
+
     inline const std::vector<std::unique_ptr<GameObject>>& GetEntities() const noexcept { return mEntities; }
 
     using CameraProperty = PropertyRO<Scene, Camera2D*,
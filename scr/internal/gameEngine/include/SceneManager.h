@@ -20,6 +20,14 @@ class SceneManager : public Singleton<SceneManager>
 {
     friend class Singleton<SceneManager>;
     friend class Engine;
+    friend class Scene;
+
+    struct Config
+    {
+        // Presupuesto de activacion por frame para objetos nuevos (0 = sin limite)
+        float activationBudgetMs = 0.f;
+        int activationBudgetCount = 0;
+    };
 
 private:
     SceneManager() = default;
@@ -51,7 +59,17 @@ private:
     std::unique_ptr<Scene> mPendingScene;
     bool mHasPending = false;
 
-    bool Init() noexcept;
+    // Presupuesto de activacion (Awake/Start/OnEnable de objetos nuevos)
+    float mActivationBudgetMs = 0.f;
+    int mActivationBudgetCount = 0;
+
+    bool Init(const Config& cfg) noexcept;
+
+    inline float GetActivationBudgetMs() const noexcept { return mActivationBudgetMs; }
+    inline void SetActivationBudgetMs(float ms) noexcept { mActivationBudgetMs = (ms < 0.f) ? 0.f : ms; }
+    inline int GetActivationBudgetCount() const noexcept { return mActivationBudgetCount; }
+    inline void SetActivationBudgetCount(int n) noexcept { mActivationBudgetCount = (n < 0) ? 0 : n; }
+    inline bool HasActivationBudget_() const noexcept { return mActivationBudgetMs > 0.f || mActivationBudgetCount > 0; }
 
     void Shutdown() noexcept;
 
@@ -70,6 +88,8 @@ public:
     // --- Gestin de escenas ---
 
     void Register(const std::string& id, SceneBuilder builder) noexcept;
+    // Escena construida desde un snapshot binario (.xscn) en lugar de una lambda
+    void RegisterSnapshot(const std::string& id, const std::string& path) noexcept;
     void SetPersistent(const std::string& id, bool persistent) noexcept;
 
     void SetActive(std::unique_ptr<Scene> s) noexcept;
@@ -78,4 +98,16 @@ public:
     // Obtener punteros (no ownership)
     inline Scene* GetActive() noexcept { return mActive.get(); }
     inline const Scene* GetActive() const noexcept { return mActive.get(); }
+
+    // Objetos nuevos con prioridad Normal se activan repartidos entre frames
+    // respetando estos limites; los Immediate siempre en el mismo frame.
+    using ActivationBudgetMsProp = Property<SceneManager, float,
+        &SceneManager::GetActivationBudgetMs,
+        &SceneManager::SetActivationBudgetMs>;
+    ActivationBudgetMsProp activationBudgetMs{ this };
+
+    using ActivationBudgetCountProp = Property<SceneManager, int,
+        &SceneManager::GetActivationBudgetCount,
+        &SceneManager::SetActivationBudgetCount>;
+    ActivationBudgetCountProp activationBudgetCount{ this };
 };
\ No newline at end of file
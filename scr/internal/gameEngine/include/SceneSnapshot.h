@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <functional>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+
+#include "GameObject.h"
+
+class Scene;
+class Behaviour;
+
+// =========================
+// SceneSnapshot
+// =========================
+//
+// Formato binario compacto de escena (".xscn"):
+//
+//   [Header][BlockDesc x N][bloques ...][tabla de strings]
+//
+// - Cada bloque es un array contiguo de registros POD de un solo tipo
+//   (entidades, Transform, SpriteRenderer, Collider2D, RigidBody2D, scripts...).
+// - Las entidades se escriben en orden padre -> hijos, asi la jerarquia se
+//   reconstruye en una sola pasada (parent < indice propio).
+// - Los strings (nombres, tags, claves de textura, tipos de script) van en una
+//   tabla unica y los registros guardan offsets.
+//
+// La carga mapea el fichero en memoria y recorre los bloques tal cual, sin
+// parsear campo a campo. Los Behaviours de juego solo se guardan si su tipo
+// esta registrado con RegisterBehaviour<T>(); sus datos propios pasan por
+// Behaviour::OnSnapshotSave / OnSnapshotLoad.
+class SceneSnapshot
+{
+public:
+    using BehaviourFactory = std::function<Behaviour* (GameObject&)>;
+
+    // Guarda la escena en memoria / disco
+    static bool Write(const Scene& scene, std::vector<uint8_t>& out) noexcept;
+    static bool SaveToFile(const Scene& scene, const std::string& path) noexcept;
+
+    // Guarda solo unos objetos raiz y sus descendientes (sin camara)
+    static bool WriteObjects(const Scene& scene, const std::vector<GameObject*>& roots, std::vector<uint8_t>& out) noexcept;
+
+    // Carga (anade los objetos a la escena indicada)
+    static bool Read(Scene& scene, const uint8_t* data, size_t size) noexcept;
+    static bool LoadFromFile(Scene& scene, const std::string& path) noexcept;
+
+    // Registro de scripts serializables: el nombre es el que se guarda en disco
+    template<class T>
+    static void RegisterBehaviour(const std::string& typeName)
+    {
+        Registry& r = GetRegistry_();
+        r.names[std::type_index(typeid(T))] = typeName;
+        r.factories[typeName] = [](GameObject& go) -> Behaviour* { return go.AddComponent<T>(); };
+    }
+
+private:
+    struct Registry
+    {
+        std::unordered_map<std::type_index, std::string> names;
+        std::unordered_map<std::string, BehaviourFactory> factories;
+    };
+
+    static Registry& GetRegistry_() noexcept;
+
+    static bool Write_(const Scene& scene, const std::vector<GameObject*>& order, bool withCamera, std::vector<uint8_t>& out) noexcept;
+};
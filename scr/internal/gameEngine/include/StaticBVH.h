@@ -0,0 +1,120 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "BaseTypes.h"
+
+// =========================
+// StaticBVH
+// =========================
+//
+// BVH inmutable para colliders que no se mueven:
+// - Se construye de una vez (Build) partiendo por la mediana del eje mas largo.
+// - Nodos en un array plano en preorden: el hijo izquierdo es siempre i + 1 y
+//   cada nodo guarda el indice por el que se sigue si no solapa (escape). La
+//   consulta es un bucle lineal sin pila ni punteros.
+// - Hojas de hasta kLeafSize items contiguos.
+// Si algo cambia se reconstruye entero (Build), no hay insercion incremental.
+class StaticBVH
+{
+public:
+    static constexpr int kLeafSize = 4;
+
+    StaticBVH() noexcept = default;
+
+    // boxes[i] es el AABB del item i; las consultas devuelven esos indices
+    void Build(const std::vector<Rect>& boxes) noexcept;
+    // Igual sobre un tramo: las consultas devuelven indexBase + i
+    void Build(const Rect* boxes, size_t count, uint32_t indexBase) noexcept;
+    void Clear() noexcept;
+
+    inline size_t GetItemCount() const noexcept { return mItems.size(); }
+    inline size_t GetNodeCount() const noexcept { return mNodes.size(); }
+
+    // callback(uint32_t item) -> bool (false = parar)
+    template<class F>
+    void Query(const Rect& aabb, F&& callback) const
+    {
+        const int32_t n = (int32_t)mNodes.size();
+        int32_t i = 0;
+
+        while (i < n)
+        {
+            const Node& node = mNodes[i];
+            if (!node.aabb.Overlaps(aabb))
+            {
+                i = node.escape;
+                continue;
+            }
+
+            if (node.count > 0)
+            {
+                for (int32_t k = 0; k < node.count; ++k)
+                {
+                    const Item& it = mItems[node.first + k];
+                    if (it.aabb.Overlaps(aabb) && !callback(it.index)) return;
+                }
+                i = node.escape;
+            }
+            else
+            {
+                ++i;
+            }
+        }
+    }
+
+    // Igual que DynamicAABBTree::RayCast: callback(uint32_t item, float maxT) -> float
+    template<class F>
+    void RayCast(const Vec2& origin, const Vec2& dir, float maxT, F&& callback) const
+    {
+        const int32_t n = (int32_t)mNodes.size();
+        int32_t i = 0;
+
+        while (i < n)
+        {
+            const Node& node = mNodes[i];
+            if (!node.aabb.IntersectsRay(origin, dir, maxT))
+            {
+                i = node.escape;
+                continue;
+            }
+
+            if (node.count > 0)
+            {
+                for (int32_t k = 0; k < node.count; ++k)
+                {
+                    const Item& it = mItems[node.first + k];
+                    if (!it.aabb.IntersectsRay(origin, dir, maxT)) continue;
+                    maxT = callback(it.index, maxT);
+                    if (maxT < 0.f) return;
+                }
+                i = node.escape;
+            }
+            else
+            {
+                ++i;
+            }
+        }
+    }
+
+private:
+    struct Node
+    {
+        Rect aabb;
+        int32_t escape = 0;     // siguiente nodo si se descarta este subarbol
+        int32_t first = 0;      // hojas: primer item
+        int32_t count = 0;      // hojas: numero de items (0 = nodo interno)
+    };
+
+    struct Item
+    {
+        Rect aabb;
+        uint32_t index = 0;
+    };
+
+    void Build_(int32_t first, int32_t count) noexcept;
+
+    std::vector<Node> mNodes;
+    std::vector<Item> mItems;
+};
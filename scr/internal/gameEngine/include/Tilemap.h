@@ -0,0 +1,169 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "Behaviour.h"
+#include "Assets.h"
+#include "BaseTypes.h"
+#include "Property.h"
+
+class Collider2D;
+using LayerBits = uint32_t;
+
+// =========================
+// Tilemap
+// =========================
+//
+// Rejilla de IDs de tile que se dibujan desde un atlas (celdas de tilePixelSize,
+// numeradas por filas: id = fila * columnas + columna; kEmpty = sin tile).
+// La tile (0,0) tiene su esquina superior izquierda en la posicion del Transform;
+// se aplican posicion y escala (no la rotacion).
+//
+// Colision: las tiles solidas adyacentes se juntan en rectangulos con un barrido
+// greedy (pocos, no necesariamente el minimo) y cada rectangulo es un Collider2D
+// estatico de un hijo "<nombre>Collision".
+// Limitacion: los pares de colision son por GameObject, asi que un cuerpo que toca
+// varios rectangulos a la vez tiene un solo par con el Tilemap (un Enter/Exit; un
+// Stay por rectangulo). La cache de warm starting del par guarda
+// PairTable::Pair::kMaxCachedImpulses puntos: dos manifolds (suelo + pared en una
+// esquina); los puntos de un tercer rectangulo arrancan sin impulso previo.
+// La rejilla se trocea en franjas de collisionStripRows filas: editar una tile
+// solo rehace los rectangulos de su franja (al principio del siguiente FixedUpdate
+// o Update, o ya con RebuildCollision()).
+class Tilemap : public Behaviour
+{
+public:
+    static constexpr int32_t kEmpty = -1;
+
+private:
+    // --- Rejilla ---
+    int width_ = 0;
+    int height_ = 0;
+    Vec2 tileSize_{ 1.f, 1.f };         // tamano de una tile en unidades de mundo (antes de escala)
+    std::vector<int32_t> tiles_;
+
+    // --- Atlas ---
+    const Texture* atlas_ = nullptr;
+    Vec2I tilePixelSize_{ 0, 0 };       // 0 => atlas entero como una sola tile
+    Color tint_ = { 255, 255, 255, 255 };
+
+    // --- Colision ---
+    bool collision_ = true;
+    LayerBits layer_ = 1u << 0;
+    LayerBits mask_ = 0xFFFFFFFFu;
+    int stripRows_ = 32;
+    std::vector<uint8_t> nonSolid_;     // por ID: 1 = no genera colision
+
+    // Rectangulos (en tiles) y colliders de una franja de filas
+    struct Strip
+    {
+        std::vector<RectI> rects;
+        std::vector<Collider2D*> colliders;    // uno por rect, habilitados
+        bool dirty = true;
+    };
+    std::vector<Strip> strips_;
+    std::vector<Collider2D*> spare_;     // colliders deshabilitados para reutilizar
+    std::vector<uint8_t> usedScratch_;
+    std::vector<RectI> rectScratch_;
+    bool anyDirty_ = true;
+    bool settingsDirty_ = false;        // layer/mask/tileSize: hay que tocar todos los colliders
+
+    GameObject* collisionObject_ = nullptr;
+
+    int GetWidth() const noexcept { return width_; }
+    int GetHeight() const noexcept { return height_; }
+    Vec2 GetTileSize() const noexcept { return tileSize_; }
+    void SetTileSize(Vec2 s) noexcept;
+
+    const Texture* GetAtlas() const noexcept { return atlas_; }
+    void SetAtlas(const Texture* tex) noexcept { atlas_ = tex; }
+    Vec2I GetTilePixelSize() const noexcept { return tilePixelSize_; }
+    void SetTilePixelSize(Vec2I s) noexcept { tilePixelSize_ = s; }
+    Color GetTint() const noexcept { return tint_; }
+    void SetTint(Color c) noexcept { tint_ = c; }
+
+    bool GetCollision() const noexcept { return collision_; }
+    void SetCollision(bool c) noexcept;
+    LayerBits GetLayer() const noexcept { return layer_; }
+    void SetLayer(LayerBits l) noexcept;
+    LayerBits GetMask() const noexcept { return mask_; }
+    void SetMask(LayerBits m) noexcept;
+    int GetStripRows() const noexcept { return stripRows_; }
+    void SetStripRows(int rows) noexcept;
+
+    int GetColliderCount() const noexcept;
+
+    bool IsSolid_(int x, int y) const noexcept;
+    void MarkDirty_(int y) noexcept;
+    void MarkAllDirty_() noexcept;
+    void ResetStrips_() noexcept;
+    void RebuildStrip_(int s) noexcept;
+    void ApplyRect_(Collider2D* col, const RectI& r) const noexcept;
+    void RebuildDirty_() noexcept;
+
+protected:
+    void Awake() override;
+    void OnEnable() override;
+    void OnDisable() override;
+    void FixedUpdate(float dt) override;
+    void Update(float dt) override;
+    void Render() override;
+
+public:
+    Tilemap() = default;
+    ~Tilemap() override = default;
+
+    // Redimensiona la rejilla; todo queda vacio
+    void Resize(int width, int height) noexcept;
+
+    int32_t GetTile(int x, int y) const noexcept;
+    void SetTile(int x, int y, int32_t id) noexcept;
+    void Fill(int x, int y, int w, int h, int32_t id) noexcept;
+    void Clear() noexcept;
+
+    // Por defecto toda tile no vacia es solida
+    void SetTileSolid(int32_t id, bool solid) noexcept;
+    bool IsTileSolid(int32_t id) const noexcept;
+
+    // Celda que contiene un punto de mundo (false si cae fuera de la rejilla)
+    bool WorldToCell(Vec2 world, int& x, int& y) const noexcept;
+    // Centro en mundo de una celda
+    Vec2 CellToWorld(int x, int y) const noexcept;
+
+    // Rehace ya las franjas pendientes (si no, se hace en el siguiente FixedUpdate/Update)
+    void RebuildCollision() noexcept;
+
+    using WidthProp = PropertyRO<Tilemap, int, &Tilemap::GetWidth>;
+    WidthProp width{ this };
+
+    using HeightProp = PropertyRO<Tilemap, int, &Tilemap::GetHeight>;
+    HeightProp height{ this };
+
+    using TileSizeProp = Property<Tilemap, Vec2, &Tilemap::GetTileSize, &Tilemap::SetTileSize>;
+    TileSizeProp tileSize{ this };
+
+    using AtlasProp = Property<Tilemap, const Texture*, &Tilemap::GetAtlas, &Tilemap::SetAtlas>;
+    AtlasProp atlas{ this };
+
+    using TilePixelSizeProp = Property<Tilemap, Vec2I, &Tilemap::GetTilePixelSize, &Tilemap::SetTilePixelSize>;
+    TilePixelSizeProp tilePixelSize{ this };
+
+    using TintProp = Property<Tilemap, Color, &Tilemap::GetTint, &Tilemap::SetTint>;
+    TintProp tint{ this };
+
+    using CollisionProp = Property<Tilemap, bool, &Tilemap::GetCollision, &Tilemap::SetCollision>;
+    CollisionProp collision{ this };
+
+    using LayerProp = Property<Tilemap, LayerBits, &Tilemap::GetLayer, &Tilemap::SetLayer>;
+    LayerProp layer{ this };
+
+    using MaskProp = Property<Tilemap, LayerBits, &Tilemap::GetMask, &Tilemap::SetMask>;
+    MaskProp mask{ this };
+
+    using StripRowsProp = Property<Tilemap, int, &Tilemap::GetStripRows, &Tilemap::SetStripRows>;
+    StripRowsProp collisionStripRows{ this };
+
+    using ColliderCountProp = PropertyRO<Tilemap, int, &Tilemap::GetColliderCount>;
+    ColliderCountProp colliderCount{ this };
+};
@@ -16,8 +16,10 @@
 //============= COMPONENT SYSTEM =============
 #include "Component.h"
 #include "Behaviour.h"
+#include "Coroutine.h"
 #include "Transform.h"
 #include "SpriteRenderer.h"
+#include "Tilemap.h"
 #include "RigidBody2D.h"
 #include "Collider2D.h"
 #include "GameObject.h"
@@ -38,6 +40,7 @@
 //============= ESCENA / CMARA / MOTOR =============
 #include "Camera2D.h"
 #include "Scene.h"
+#include "SceneSnapshot.h"
 #include "Engine.h"
 
 #define Time      TimeManager::GetInstancePtr()
@@ -49,6 +52,7 @@
 #define UI        UIManager::GetInstancePtr()
 #define Window    WindowManager::GetInstancePtr()
 #define Physics   PhysicsManager::GetInstancePtr()
+#define Collision CollisionManager::GetInstancePtr()
 #define Random	  RandomManager::GetInstancePtr()
 
 #define CurrentCamera Engine::GetInstancePtr()->camera
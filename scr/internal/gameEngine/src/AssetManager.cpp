@@ -322,6 +322,15 @@ Texture* AssetManager::GetTextureByKey(const std::string& key) const noexcept
     return nullptr;
 }
 
+std::string AssetManager::FindTextureKey(const Texture* tex) const noexcept
+{
+    if (!tex) return {};
+    for (auto& kv : mTextures)
+        if (kv.second.get() == tex)
+            return kv.first;
+    return {};
+}
+
 // =======================
 // FUENTES
 // =======================
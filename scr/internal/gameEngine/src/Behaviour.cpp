@@ -11,4 +11,26 @@ Transform* Behaviour::GetTransform() const noexcept
 Scene* Behaviour::GetScene() const noexcept
 {
 	return (mGameObject) ? mGameObject->scene : nullptr;
-}
\ No newline at end of file
+}
+
+Behaviour::~Behaviour()
+{
+	StopAllCoroutines();
+}
+
+void Behaviour::StartCoroutine(Coroutine co) noexcept
+{
+	Scene* s = GetScene();
+	if (!s || !co.mHandle) return;
+
+	auto h = co.Release();
+	auto& p = h.promise();
+	p.owner = this;
+
+	s->mCoroutines.Start(&p);
+}
+
+void Behaviour::StopAllCoroutines() noexcept
+{
+	if (mCoroutines) mCoroutines->scheduler->StopAll(this);
+}
@@ -117,6 +117,54 @@ Rect Collider2D::WorldAABB() const noexcept
     return { center.x - ex, center.y - ey, ex * 2.f, ey * 2.f };
 }
 
+Collider2D::WorldShape Collider2D::ComputeWorldShape() const noexcept
+{
+    const Transform* tr = mGameObject ? (Transform*)mGameObject->transform : nullptr;
+    if (!tr) return WorldShape{};
+
+    return ComputeWorldShape(tr->position, tr->scale, tr->rotation->z);
+}
+
+Collider2D::WorldShape Collider2D::ComputeWorldShape(const Vec3& wpos, const Vec2& wsc, float rotZ) const noexcept
+{
+    WorldShape ws{};
+
+    // sin/cos de la rotacion del Transform (offset) y del angulo final (box)
+    const float rr = DegToRad(rotZ);
+    const float cz = std::cos(rr), sz = std::sin(rr);
+
+    Vec2 offs = { offsetLocal_.x * wsc.x, offsetLocal_.y * wsc.y };
+    if (inheritRotation_)
+        offs = { cz * offs.x - sz * offs.y, sz * offs.x + cz * offs.y };
+    ws.center = { wpos.x + offs.x, wpos.y + offs.y };
+
+    if (shape_ == Shape::Circle)
+    {
+        const float r = radiusLocal_ * std::max(wsc.x, wsc.y);
+        ws.radius = r;
+        ws.rot = { 1.f, 0.f };
+        ws.aabb = { ws.center.x - r, ws.center.y - r, r * 2.f, r * 2.f };
+        return ws;
+    }
+
+    ws.half = { 0.5f * sizeLocal_.x * wsc.x, 0.5f * sizeLocal_.y * wsc.y };
+
+    if (inheritRotation_ && localAngleOffsetDeg_ == 0.f)
+    {
+        ws.rot = { cz, sz };
+    }
+    else
+    {
+        const float a = DegToRad((inheritRotation_ ? rotZ : 0.f) + localAngleOffsetDeg_);
+        ws.rot = { std::cos(a), std::sin(a) };
+    }
+
+    const float ex = std::fabs(ws.rot.x * ws.half.x) + std::fabs(ws.rot.y * ws.half.y);
+    const float ey = std::fabs(ws.rot.y * ws.half.x) + std::fabs(ws.rot.x * ws.half.y);
+    ws.aabb = { ws.center.x - ex, ws.center.y - ey, ex * 2.f, ey * 2.f };
+    return ws;
+}
+
 //std::unique_ptr<Component> Collider2D::Clone(GameObject* newOwner) const
 //{
 //    auto up = std::make_unique<Collider2D>();   // ctor por defecto Properties ya rebinded a *up
@@ -155,6 +203,55 @@ RigidBody2D* Collider2D::GetAttachedBody() const noexcept
     return nullptr;
 }
 
+Collider2D::BodyClass Collider2D::ResolveBodyClass() const noexcept
+{
+    if (bodyClass_ != BodyClass::Auto) return bodyClass_;
+
+    RigidBody2D* rb = GetAttachedBody();
+    if (!rb) return BodyClass::Kinematic;   // se mueve por Transform
+
+    const RigidBody2D::BodyType type = rb->bodyType;
+    switch (type)
+    {
+    case RigidBody2D::BodyType::Static:    return BodyClass::Static;
+    case RigidBody2D::BodyType::Kinematic: return BodyClass::Kinematic;
+    default:                               return BodyClass::Dynamic;
+    }
+}
+
+void Collider2D::SetBodyClass(BodyClass c) noexcept
+{
+    bodyClass_ = c;
+    if (auto* cm = CollisionManager::GetInstancePtr())
+        cm->RefreshCollider(this);
+}
+
+void Collider2D::SetLayer(LayerBits l) noexcept
+{
+    if (layer_ == l) return;
+    layer_ = l;
+    // Cambia de cubo de capa en el broadphase (o se re-hornea si es estatico)
+    if (auto* cm = CollisionManager::GetInstancePtr())
+        cm->RefreshCollider(this);
+}
+
+void Collider2D::SetMask(LayerBits m) noexcept
+{
+    if (mask_ == m) return;
+    mask_ = m;
+    if (auto* cm = CollisionManager::GetInstancePtr())
+        cm->RefreshCollider(this);
+}
+
+void Collider2D::SetIsTrigger(bool trigger) noexcept
+{
+    if (isTrigger_ == trigger) return;
+    isTrigger_ = trigger;
+    // Cambia de arbol (solidos/triggers) o se re-hornea si es estatico
+    if (auto* cm = CollisionManager::GetInstancePtr())
+        cm->RefreshCollider(this);
+}
+
 void Collider2D::Awake()
 {
 	CollisionManager::GetInstancePtr()->RegisterCollider(this);
@@ -162,7 +259,7 @@ void Collider2D::Awake()
 
 void Collider2D::OnEnable()
 {
-    CollisionManager::GetInstancePtr()->SetColliderActive(this, true);
+    CollisionManager::GetInstancePtr()->SetColliderActive(this, !gameObject->streamedOut);
 }
 
 void Collider2D::OnDisable()
@@ -227,6 +324,6 @@ void Collider2D::Register()
     if (mAwoken && mStarted)
     {
         CollisionManager::GetInstancePtr()->RegisterCollider(this);
-        CollisionManager::GetInstancePtr()->SetColliderActive(this, mEnabled && gameObject->activeInHierarchy);
+        CollisionManager::GetInstancePtr()->SetColliderActive(this, mEnabled && gameObject->activeInHierarchy && !gameObject->streamedOut);
     }
 }
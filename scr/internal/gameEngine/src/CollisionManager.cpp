@@ -2,14 +2,23 @@
 
 #include <vector>
 #include <cmath>
+#include <cfloat>
 #include <algorithm>
+#include <bit>
 
 #include "Collider2D.h"
 #include "GameObject.h"
 #include "RigidBody2D.h"
+#include "Transform.h"
+#include "PhysicsManager.h"
+#include "JobSystem.h"
 
 using std::vector;
 
+// Reparto del narrowphase entre hilos
+static constexpr size_t kMinPairsPerNarrowJob = 64;   // por debajo no compensa despertar hilos
+static constexpr size_t kNarrowJobsPerThread = 4;     // tramos de sobra para equilibrar carga
+
 // =================== Utilidades geomtricas internas ===================
 static inline float AbsDot(Vec2 vecA, Vec2 vecB) noexcept {
     return std::fabs(math::Dot(vecA, vecB));
@@ -41,13 +50,10 @@ struct Basis2 {
     Vec2 y; // axisY
 };
 
-static inline Basis2 OBBBases(float rotDeg) noexcept
+static inline Basis2 OBBBases(const Vec2& rot) noexcept
 {
-    const float r = DegToRad(rotDeg);
-    const float c = std::cos(r);
-    const float s = std::sin(r);
-    // eje X rotado, eje Y rotado (ortonormales)
-    return { Vec2{c, s}, Vec2{-s, c} };
+    // rot = (cos, sin): eje X rotado, eje Y rotado (ortonormales)
+    return { Vec2{rot.x, rot.y}, Vec2{-rot.y, rot.x} };
 }
 
 static inline Vec2 WorldToLocal(const Vec2& pWorld, const Vec2& centerWorld, const Basis2& b) noexcept
@@ -98,10 +104,10 @@ bool CollisionManager::Contact_Circle_Circle(const Vec2& ca, float ra,
 // Devuelve normalA apuntando de CRCULO (A) hacia OBB (B): circle->box
 bool CollisionManager::Contact_OBB_Circle(const Vec2& cc, float r,
     const Vec2& bc, const Vec2& half,
-    float rotDeg,
+    const Vec2& rot,
     ContactPoint& out) noexcept
 {
-    const Basis2 b = OBBBases(rotDeg);
+    const Basis2 b = OBBBases(rot);
 
     // 1) crculo a espacio local del box
     const Vec2 cLocal = WorldToLocal(cc, bc, b);
@@ -227,10 +233,37 @@ static inline Vec2 SupportPointOBB(const Vec2& center, const Basis2& b, const Ve
     return center + b.x * sx + b.y * sy;
 }
 
-bool CollisionManager::Contact_OBB_OBB(const Vec2& ac, const Vec2& aHalf, float aRotDeg, const Vec2& bc, const Vec2& bHalf, float bRotDeg, ContactPoint& out) noexcept
+// Recorta el segmento v[0..1] al semiplano dot(n, x) <= o. ids sigue de donde
+// sale cada punto; los nuevos se marcan con clipId.
+static inline int ClipSegment_(Vec2 v[2], uint32_t ids[2], const Vec2& n, float o, uint32_t clipId) noexcept
 {
-    const Basis2 aB = OBBBases(aRotDeg);
-    const Basis2 bB = OBBBases(bRotDeg);
+    const float d0 = math::Dot(n, v[0]) - o;
+    const float d1 = math::Dot(n, v[1]) - o;
+
+    Vec2 outV[2];
+    uint32_t outIds[2];
+    int count = 0;
+
+    if (d0 <= 0.f) { outV[count] = v[0]; outIds[count++] = ids[0]; }
+    if (d1 <= 0.f) { outV[count] = v[1]; outIds[count++] = ids[1]; }
+
+    if (d0 * d1 < 0.f && count < 2)
+    {
+        const float t = d0 / (d0 - d1);
+        outV[count] = v[0] + (v[1] - v[0]) * t;
+        outIds[count++] = clipId;
+    }
+
+    for (int i = 0; i < count; ++i) { v[i] = outV[i]; ids[i] = outIds[i]; }
+    return count;
+}
+
+bool CollisionManager::Contact_OBB_OBB(const Vec2& ac, const Vec2& aHalf, const Vec2& aRot, const Vec2& bc, const Vec2& bHalf, const Vec2& bRot, ContactPoint& out, ContactManifold& manifold) noexcept
+{
+    manifold.count = 0;
+
+    const Basis2 aB = OBBBases(aRot);
+    const Basis2 bB = OBBBases(bRot);
 
     // ejes candidatos SAT (4): ax, ay, bx, by
     Vec2 axes[4] = { aB.x, aB.y, bB.x, bB.y };
@@ -274,8 +307,76 @@ bool CollisionManager::Contact_OBB_OBB(const Vec2& ac, const Vec2& aHalf, float
     }
 
     out.normalA = bestAxis;
+    out.normalB = -bestAxis;
     out.penetration = bestPen;
 
+    // ---- Manifold por clipping ----
+    // Referencia = caja duena del eje ganador; incidente = la otra.
+    // nRef sale de la referencia hacia la incidente.
+    const bool refIsB = (bestIndex >= 2);
+    const Vec2 rc = refIsB ? bc : ac;
+    const Vec2 ic = refIsB ? ac : bc;
+    const Basis2& rB = refIsB ? bB : aB;
+    const Basis2& iB = refIsB ? aB : bB;
+    const Vec2& rHalf = refIsB ? bHalf : aHalf;
+    const Vec2& iHalf = refIsB ? aHalf : bHalf;
+    const Vec2 nRef = refIsB ? -bestAxis : bestAxis;
+
+    // Cara de referencia: eje (0 = x, 1 = y) y sentido
+    const int refAxis = bestIndex & 1;
+    const Vec2 rAxis = refAxis ? rB.y : rB.x;
+    const Vec2 rSide = refAxis ? rB.x : rB.y;
+    const float rExt = refAxis ? rHalf.y : rHalf.x;
+    const float rSideExt = refAxis ? rHalf.x : rHalf.y;
+    const uint32_t refFace = (uint32_t)refAxis * 2u + (math::Dot(nRef, rAxis) < 0.f ? 1u : 0u);
+
+    // Cara incidente: la mas antiparalela a nRef
+    const float dx = math::Dot(nRef, iB.x);
+    const float dy = math::Dot(nRef, iB.y);
+    const int incAxis = (std::abs(dy) > std::abs(dx)) ? 1 : 0;
+    const float dInc = incAxis ? dy : dx;
+    const Vec2 iAxis = incAxis ? iB.y : iB.x;
+    const Vec2 iSide = incAxis ? iB.x : iB.y;
+    const float iExt = incAxis ? iHalf.y : iHalf.x;
+    const float iSideExt = incAxis ? iHalf.x : iHalf.y;
+    const float iSign = (dInc > 0.f) ? -1.f : 1.f;
+    const uint32_t incFace = (uint32_t)incAxis * 2u + (iSign < 0.f ? 1u : 0u);
+
+    const Vec2 faceC = ic + iAxis * (iExt * iSign);
+    Vec2 v[2] = { faceC - iSide * iSideExt, faceC + iSide * iSideExt };
+    uint32_t vid[2] = { 0u, 1u };
+
+    // Laterales de la cara de referencia
+    const float sideC = math::Dot(rSide, rc);
+    int n = ClipSegment_(v, vid, -rSide, -(sideC - rSideExt), 2u);
+    if (n == 2) n = ClipSegment_(v, vid, rSide, sideC + rSideExt, 3u);
+
+    if (n == 2)
+    {
+        const float refPlane = math::Dot(nRef, rc) + rExt;
+        const uint32_t featureId = (refIsB ? 1u : 0u) | (refFace << 1) | (incFace << 3);
+
+        for (int i = 0; i < 2; ++i)
+        {
+            const float pen = refPlane - math::Dot(nRef, v[i]);
+            if (pen < 0.f) continue;
+
+            // A medio camino entre el vertice incidente y la cara de referencia
+            ManifoldPoint& mp = manifold.points[manifold.count++];
+            mp.point = v[i] + nRef * (pen * 0.5f);
+            mp.penetration = pen;
+            mp.id = featureId | (vid[i] << 5);
+        }
+    }
+
+    if (manifold.count > 0)
+    {
+        Vec2 sum{ 0.f, 0.f };
+        for (const ManifoldPoint& mp : manifold) sum += mp.point;
+        out.point = sum * (1.f / (float)manifold.count);
+        return true;
+    }
+
     // Punto de contacto aproximado pero MUY til para torque:
     // usar soporte en direccin normal en A y soporte en direccin opuesta en B, y promediar
     const float ra = ProjectRadius(out.normalA, aB, aHalf);
@@ -286,224 +387,836 @@ bool CollisionManager::Contact_OBB_OBB(const Vec2& ac, const Vec2& aHalf, float
 
     out.point = (pA + pB) * 0.5f;
 
+    // Clipping degenerado: un solo punto aproximado (id propio, fuera del rango de features)
+    manifold.points[0] = { out.point, out.penetration, 1u << 8 };
+    manifold.count = 1;
+
     return true;
 }
 
 // =================== API pblica ===================
-bool CollisionManager::Init() noexcept {
-    mRegisteredColliders.clear();
-    mPrevPairs.clear();
-    mCurrPairs.clear();
-    mPrevInfo.clear();
-    mCurrInfo.clear();
+bool CollisionManager::Init(const Config& cfg) noexcept {
+    mWorld = World{};
+    mSuspendedWorlds.clear();
+
+    ResetLayerCollisions();
+    for (const auto& [a, b] : cfg.ignoreLayerPairs)
+        SetLayerCollision(a, b, false);
+
     return true;
 }
 
 void CollisionManager::Shutdown() noexcept {
     ClearAll();
+    mSuspendedWorlds.clear();
 }
 
 void CollisionManager::ClearAll() noexcept {
-    mRegisteredColliders.clear();
-    mPrevPairs.clear();
-    mCurrPairs.clear();
-    mPrevInfo.clear();
-    mCurrInfo.clear();
+    mWorld = World{};
+}
+
+void CollisionManager::SuspendWorld(const Scene* scene) noexcept {
+    if (!scene) { ClearAll(); return; }
+    // move de contenedores: O(1), no se toca ningun collider
+    mSuspendedWorlds[scene] = std::move(mWorld);
+    mWorld = World{};
+}
+
+bool CollisionManager::ResumeWorld(const Scene* scene) noexcept {
+    auto it = mSuspendedWorlds.find(scene);
+    if (it == mSuspendedWorlds.end()) return false;
+    mWorld = std::move(it->second);
+    mSuspendedWorlds.erase(it);
+    return true;
+}
+
+void CollisionManager::DiscardWorld(const Scene* scene) noexcept {
+    mSuspendedWorlds.erase(scene);
+}
+
+void CollisionManager::SetLayerCollision(int layerA, int layerB, bool collide) noexcept {
+    if (layerA < 0 || layerA >= kLayerCount || layerB < 0 || layerB >= kLayerCount)
+    {
+        LogError("CollisionManager::SetLayerCollision()", "Layer index out of range (0..31).");
+        return;
+    }
+
+    const LayerBits bitA = 1u << layerA;
+    const LayerBits bitB = 1u << layerB;
+    if (collide)
+    {
+        mLayerMatrix[layerA] |= bitB;
+        mLayerMatrix[layerB] |= bitA;
+    }
+    else
+    {
+        mLayerMatrix[layerA] &= ~bitB;
+        mLayerMatrix[layerB] &= ~bitA;
+    }
+    // No hace falta reconstruir nada: el broadphase lee la matriz en cada pasada
+}
+
+bool CollisionManager::GetLayerCollision(int layerA, int layerB) const noexcept {
+    if (layerA < 0 || layerA >= kLayerCount || layerB < 0 || layerB >= kLayerCount) return false;
+    return (mLayerMatrix[layerA] & (1u << layerB)) != 0;
+}
+
+void CollisionManager::ResetLayerCollisions() noexcept {
+    for (LayerBits& row : mLayerMatrix) row = 0xFFFFFFFFu;
 }
 
 void CollisionManager::RegisterCollider(Collider2D* c) noexcept {
     if (!c) return;
     // Por defecto activo si el Behaviour est enabled (el ciclo de vida lo controla), aqu se guarda el flag lgico
-    mRegisteredColliders[c] = true;
+    auto [it, inserted] = mWorld.colliders.try_emplace(c);
+    // Claves de otro mundo (ClearAll, clon): no son pares de esta tabla
+    if (inserted) c->pairKeys_.clear();
+    ColliderEntry& e = it->second;
+    e.active = true;
+    SyncEntry_(c, e, false);
+    mWorld.version = ++mVersionCounter;
 }
 
 void CollisionManager::RemoveCollider(Collider2D* c) noexcept {
     if (!c) return;
-    mRegisteredColliders.erase(c);
-    // Limpia pares pendientes con c
-    if (!mPrevPairs.empty()) {
-        vector<uint64_t> toErase;
-        toErase.reserve(mPrevPairs.size());
-        for (auto key : mPrevPairs) {
-            // Dado que no hay mapa inverso desde key a ids, se vaca prevPairs.
-            // El siguiente frame no habr Stay y se disparar Exit implcito.
-            (void)key;
-        }
-        mPrevPairs.clear();
-    }
+    // Collider de otro mundo (escena aparcada que se destruye): no tocar el activo
+    auto it = mWorld.colliders.find(c);
+    if (it == mWorld.colliders.end()) return;
+    // Como desactivarlo: sale del arbol, de la lista densa y del BVH estatico
+    it->second.active = false;
+    SyncEntry_(c, it->second, false);
+    mWorld.colliders.erase(it);
+    mWorld.version = ++mVersionCounter;
+    // Quita sus pares de la tabla (sin Exit: el objeto se esta destruyendo) para
+    // que no queden punteros colgando. Solo sus claves, no toda la tabla.
+    mPairErase.clear();
+    ForEachPairOf_(c, [&](PairTable::Pair& p)
+        {
+            UnlinkPair_(p.colA == c ? p.colB : p.colA, p.key);
+            mPairErase.push_back(p.key);
+        });
+    for (uint64_t key : mPairErase) mWorld.pairs.Erase(key);
+    c->pairKeys_.clear();
 }
 
 void CollisionManager::SetColliderActive(Collider2D* c, bool active) noexcept {
     if (!c) return;
-    auto it = mRegisteredColliders.find(c);
-    if (it != mRegisteredColliders.end()) it->second = active;
+    auto it = mWorld.colliders.find(c);
+    if (it == mWorld.colliders.end()) return;
+
+    it->second.active = active;
+    SyncEntry_(c, it->second, false);
+}
+
+void CollisionManager::RefreshCollider(Collider2D* c) noexcept {
+    if (!c) return;
+    auto it = mWorld.colliders.find(c);
+    if (it == mWorld.colliders.end()) return;
+    // rebake: un Static que se ha movido a mano se re-hornea
+    SyncEntry_(c, it->second, true);
+}
+
+void CollisionManager::RefreshColliders(GameObject* go) noexcept {
+    if (!go) return;
+    for (Collider2D* c : go->GetComponents<Collider2D>())
+    {
+        if (c->GetBodyClass() != Collider2D::BodyClass::Auto) continue;
+        auto it = mWorld.colliders.find(c);
+        if (it != mWorld.colliders.end()) SyncEntry_(c, it->second, false);
+    }
+    for (GameObject* child : go->Children())
+        RefreshColliders(child);
+}
+
+void CollisionManager::SyncEntry_(Collider2D* c, ColliderEntry& e, bool rebake) noexcept {
+    const bool wantStatic = e.active && c->ResolveBodyClass() == Collider2D::BodyClass::Static;
+    const bool wantProxy = e.active && !wantStatic;
+
+    // Quitado, desactivado o re-horneado: lo que dormia apoyado en el ya no tiene
+    // soporte (un par dormido contra estatico no se vuelve a probar)
+    if (!e.active || rebake || wantStatic != e.isStatic) WakePairsOf_(c);
+
+    // Los BVH estaticos se reconstruyen enteros en el siguiente BuildContacts_
+    if (wantStatic != e.isStatic || (rebake && wantStatic)) mWorld.staticsDirty = true;
+    e.isStatic = wantStatic;
+
+    // Refresh explicito (capa, trigger...): recalcular las capas de los cubos
+    if (rebake) mWorld.dynamicsDirty = true;
+
+    // Solo los activos no estaticos viven en un arbol dinamico (solidos o triggers,
+    // del cubo de su capa) y en la lista densa (se reordena en el siguiente BuildContacts_)
+    const bool wantTrigger = c->isTrigger_;
+    const uint8_t wantBucket = BucketOf_(c->layer_);
+    if (e.proxy != DynamicAABBTree::kNull && (!wantProxy || e.inTriggerTree != wantTrigger || e.bucket != wantBucket))
+    {
+        TreeOf_(e.inTriggerTree, e.bucket).DestroyProxy(e.proxy);
+        e.proxy = DynamicAABBTree::kNull;
+        mWorld.dynamics[c->broadRank_].col = nullptr;
+        c->broadRank_ = -1;
+        mWorld.dynamicsDirty = true;
+    }
+
+    if (wantProxy && e.proxy == DynamicAABBTree::kNull)
+    {
+        e.inTriggerTree = wantTrigger;
+        e.bucket = wantBucket;
+        e.proxy = TreeOf_(wantTrigger, wantBucket).CreateProxy(c->WorldAABB(), c);
+        c->broadRank_ = (int32_t)mWorld.dynamics.size();
+        mWorld.dynamics.push_back({ c, e.proxy, wantTrigger, wantBucket });
+        mWorld.dynamicsDirty = true;
+    }
 }
 
 void CollisionManager::DetectAndDispatch() noexcept {
-    vector<NarrowContact> contacts;
-    contacts.reserve(128);
-
-    mCurrInfo.clear();
-    mCurrPairs.clear();
-    BuildContacts_(contacts);
-    nContactsBuiltThisFrame = contacts.size();
-    Dispatch_(contacts);
-
-    // Exit: pares que estaban antes y ya no estn
-    for (auto key : mPrevPairs) {
-        if (mCurrPairs.find(key) == mCurrPairs.end()) {
-            // No se conocen los punteros A/B aqu; el Exit por pareja se hace en Dispatch_
-            // Se guardan keys hurfanos para actuar: solucin simple -> no es posible reconstruir info
-            // sin mapa adicional. Por lo tanto la notificacin de Exit se realiza en Dispatch_ comparando sets.
-        }
+    // Camino normal: el ultimo substep de la fisica ya detecto todo (triggers incluidos)
+    // y nada ha vuelto a detectar despues (mismo stamp)
+    const bool reuse = mHasStepContacts && mStepContactsStamp == mWorld.stamp;
+    mHasStepContacts = false;
+
+    std::vector<NarrowContact>* contacts = &mStepContacts;
+    std::vector<NarrowContact>* triggers = &mStepTriggers;
+    if (reuse)
+    {
+        ++nDispatchReused;
+    }
+    else
+    {
+        mDispatchContacts.clear();
+        mDispatchTriggers.clear();
+        BuildContacts_(mDispatchContacts, mDispatchTriggers);
+        contacts = &mDispatchContacts;
+        triggers = &mDispatchTriggers;
+        ++nDispatchFallback;
     }
 
-    // Actualiza histrico
-    mPrevPairs.swap(mCurrPairs);
-    mPrevInfo.swap(mCurrInfo);
+    nDetectionPassesLastStep = nDetectionPasses;
+    nDetectionPasses = 0;
+
+    nContactsBuiltThisFrame = contacts->size();
+    nTriggerOverlapsThisFrame = triggers->size();
+    Dispatch_(*contacts, *triggers);
+}
+
+void CollisionManager::RestorePairs_(const PairTable& pairs, uint32_t stamp) noexcept
+{
+    mWorld.pairs = pairs;
+    mWorld.stamp = stamp;
+    mHasStepContacts = false;
+
+    // Las claves por collider salen de la tabla restaurada
+    for (auto& [c, e] : mWorld.colliders) c->pairKeys_.clear();
+    mWorld.pairs.ForEach([](PairTable::Pair& p)
+        {
+            LinkPair_(p.colA, p.key);
+            LinkPair_(p.colB, p.key);
+        });
+
+    // Los dormidos no rellenan su entrada de la cache: con las poses restauradas hay
+    // que rellenar todas en la siguiente pasada
+    for (uint8_t& f : mDynCache.flags) f &= (uint8_t)~ColliderCache::kAsleep;
+}
+
+void CollisionManager::SetStepContacts_(std::vector<NarrowContact>& contacts, std::vector<NarrowContact>& triggers) noexcept {
+    mStepContacts.swap(contacts);
+    mStepTriggers.swap(triggers);
+    mHasStepContacts = true;
+    mStepContactsStamp = mWorld.stamp;
 }
 
 // =================== Internos ===================
 
-bool CollisionManager::ShouldTest(const Collider2D& a, const Collider2D& b) noexcept {
-    if (&a == &b) return false;
-    if (!a.mGameObject || !b.mGameObject) return false;
-    if (a.mGameObject == b.mGameObject) return false; // no colisionar contra uno mismo
-    RigidBody2D* ra = a.GetAttachedBody();
-    RigidBody2D* rb = b.GetAttachedBody();
+bool CollisionManager::ShouldTest(const ColliderCache& ca, uint32_t ia, const ColliderCache& cb, uint32_t ib) noexcept {
+    GameObject* ga = ca.go[ia];
+    GameObject* gb = cb.go[ib];
+    if (!ga || !gb) return false;
+    if (ga == gb) return false; // no colisionar contra uno mismo
+    RigidBody2D* ra = ca.body[ia];
+    RigidBody2D* rb = cb.body[ib];
     if (ra && rb && ra == rb) return false; // mismo rigidbody => ignorar
 
-    // capas/mscaras
-    if ((a.GetLayer() & b.GetMask()) == 0) return false;
-    if ((b.GetLayer() & a.GetMask()) == 0) return false;
+    // capas/mascaras
+    if ((ca.layer[ia] & cb.mask[ib]) == 0) return false;
+    if ((cb.layer[ib] & ca.mask[ia]) == 0) return false;
     return true;
 }
 
-void CollisionManager::BuildContacts_(std::vector<NarrowContact>& out) noexcept
+// =================== Cache SoA ===================
+void CollisionManager::ColliderCache::Resize(size_t n)
 {
-    nBroadphaseTestsThisFrame = 0;
-    nNarrowphaseTestsThisFrame = 0;
+    col.resize(n); go.resize(n); body.resize(n); id.resize(n);
+    center.resize(n); half.resize(n); rot.resize(n); radius.resize(n); aabb.resize(n);
+    layer.resize(n); mask.resize(n); flags.resize(n);
+}
+
+Collider2D::WorldShape CollisionManager::CacheShapeOf_(const Collider2D* c, const RigidBody2D* body) noexcept
+{
+    // Los Transform de los cuerpos se escriben al final del paso fijo: entre substeps
+    // la pose buena es la del BodyStore
+    const Transform* tr = c->mGameObject ? (Transform*)c->mGameObject->transform : nullptr;
+    auto* physics = PhysicsManager::GetInstancePtr_NO_ERROR_MSG();
+
+    Vec3 pos;
+    float rotZ = 0.f;
+    if (body && physics && physics->BodyPose_(body, tr, pos, rotZ))
+        return c->ComputeWorldShape(pos, tr->scale, rotZ);
+    return c->ComputeWorldShape();
+}
+
+void CollisionManager::ColliderCache::Fill(size_t i, Collider2D* c) noexcept
+{
+    RigidBody2D* rb = c->GetAttachedBody();
+    const Collider2D::WorldShape ws = CacheShapeOf_(c, rb);
+
+    col[i] = c;
+    go[i] = c->mGameObject;
+    body[i] = rb;
+    id[i] = c->mGameObject ? c->mGameObject->GetID() : 0;
+    center[i] = ws.center;
+    half[i] = ws.half;
+    rot[i] = ws.rot;
+    radius[i] = ws.radius;
+    aabb[i] = ws.aabb;
+    layer[i] = c->layer_;
+    mask[i] = c->mask_;
+    flags[i] = (uint8_t)((c->shape_ == Collider2D::Shape::Circle ? kCircle : 0) |
+                         (c->isTrigger_ ? kTrigger : 0));
+}
+
+// Orden determinista: ID del GameObject y puntero como desempate
+bool CollisionManager::ColliderLess_(const Collider2D* a, const Collider2D* b) noexcept
+{
+    const EntityID ida = a->mGameObject ? a->mGameObject->GetID() : 0;
+    const EntityID idb = b->mGameObject ? b->mGameObject->GetID() : 0;
+    if (ida != idb) return ida < idb;
+    return a < b;
+}
+
+void CollisionManager::SortDynamics_() noexcept
+{
+    auto& d = mWorld.dynamics;
+    d.erase(std::remove_if(d.begin(), d.end(), [](const DynamicRef& r) { return r.col == nullptr; }), d.end());
+    std::sort(d.begin(), d.end(), [](const DynamicRef& a, const DynamicRef& b) { return ColliderLess_(a.col, b.col); });
+
+    for (LayerBits& l : mWorld.bucketLayers) l = 0;
+    mWorld.usedBuckets = 0;
+
+    for (size_t i = 0; i < d.size(); ++i)
+    {
+        d[i].col->broadRank_ = (int32_t)i;
+        mWorld.bucketLayers[d[i].bucket] |= d[i].col->layer_;
+        mWorld.usedBuckets |= 1u << d[i].bucket;
+    }
+
+    mWorld.dynamicsDirty = false;
+}
+
+void CollisionManager::BakeStatics_() noexcept
+{
+    World& w = mWorld;
 
-    std::vector<Collider2D*> active;
-    active.reserve(mRegisteredColliders.size());
-    for (auto& [c, isActive] : mRegisteredColliders)
-        if (c && isActive) active.push_back(c);
+    mBakeList.clear();
+    for (auto& [c, e] : w.colliders)
+        if (e.isStatic) mBakeList.push_back(c);
 
-    std::sort(active.begin(), active.end(),
-        [](const Collider2D* a, const Collider2D* b)
+    // Agrupados por cubo de capa y, dentro, en orden determinista
+    std::sort(mBakeList.begin(), mBakeList.end(), [](const Collider2D* a, const Collider2D* b)
         {
-            const EntityID ida = (a && a->mGameObject) ? a->mGameObject->GetID() : 0;
-            const EntityID idb = (b && b->mGameObject) ? b->mGameObject->GetID() : 0;
-            if (ida != idb) return ida < idb;
-            return a < b; // desempate estable
+            const uint8_t ba = BucketOf_(a->layer_), bb = BucketOf_(b->layer_);
+            if (ba != bb) return ba < bb;
+            return ColliderLess_(a, b);
         });
 
-    const size_t n = active.size();
+    w.staticCache.Resize(mBakeList.size());
+    for (size_t i = 0; i < mBakeList.size(); ++i)
+        w.staticCache.Fill(i, mBakeList[i]);
 
-    for (size_t i = 0; i < n; ++i)
+    // Un BVH por cubo sobre su tramo de la cache (los items son indices globales)
+    for (int b = 0; b < kLayerCount; ++b)
     {
-        Collider2D* A = active[i];
+        w.statics[b].Clear();
+        w.staticBucketLayers[b] = 0;
+    }
+    w.usedStaticBuckets = 0;
 
-        for (size_t j = i + 1; j < n; ++j)
+    size_t first = 0;
+    while (first < mBakeList.size())
+    {
+        const uint8_t bucket = BucketOf_(mBakeList[first]->layer_);
+        size_t last = first;
+        while (last < mBakeList.size() && BucketOf_(mBakeList[last]->layer_) == bucket)
         {
-            Collider2D* B = active[j];
-            if (!ShouldTest(*A, *B)) continue;
+            w.staticBucketLayers[bucket] |= mBakeList[last]->layer_;
+            ++last;
+        }
 
-            // Broadphase
-            nBroadphaseTestsThisFrame++;
-            if (!TestBoxBox(A->WorldAABB(), B->WorldAABB())) continue;
+        w.statics[bucket].Build(w.staticCache.aabb.data() + first, last - first, (uint32_t)first);
+        w.usedStaticBuckets |= 1u << bucket;
+        first = last;
+    }
 
-            // Narrow + ContactPoint
-            nNarrowphaseTestsThisFrame++;
+    w.staticsDirty = false;
+}
+
+bool CollisionManager::Narrow_(const ColliderCache& ca, uint32_t ia, const ColliderCache& cb, uint32_t ib, ContactPoint& cp, ContactManifold& m) noexcept
+{
+    const bool circleA = (ca.flags[ia] & ColliderCache::kCircle) != 0;
+    const bool circleB = (cb.flags[ib] & ColliderCache::kCircle) != 0;
 
-            ContactPoint cp{};
-            bool hit = false;
+    if (!circleA && !circleB)
+    {
+        return Contact_OBB_OBB(
+            ca.center[ia], ca.half[ia], ca.rot[ia],
+            cb.center[ib], cb.half[ib], cb.rot[ib],
+            cp, m
+        );
+    }
 
-            const auto sa = A->GetShape();
-            const auto sb = B->GetShape();
+    bool hit = false;
 
-            if (sa == Collider2D::Shape::Circle && sb == Collider2D::Shape::Circle)
-            {
-                auto ca = A->WorldCircle();
-                auto cb = B->WorldCircle();
-                hit = Contact_Circle_Circle(ca.center, ca.radius, cb.center, cb.radius, cp);
-            }
-            else if (sa == Collider2D::Shape::Box && sb == Collider2D::Shape::Box)
+    if (circleA && circleB)
+    {
+        hit = Contact_Circle_Circle(ca.center[ia], ca.radius[ia], cb.center[ib], cb.radius[ib], cp);
+    }
+    else if (circleA)
+    {
+        // normal A->B = circle->box
+        hit = Contact_OBB_Circle(
+            ca.center[ia], ca.radius[ia],
+            cb.center[ib], cb.half[ib], cb.rot[ib],
+            cp
+        );
+    }
+    else
+    {
+        // Box->Circle: llamar a Circle->Box y luego invertir la normal
+        // para que quede normal A->B = box->circle
+        hit = Contact_OBB_Circle(
+            cb.center[ib], cb.radius[ib],
+            ca.center[ia], ca.half[ia], ca.rot[ia],
+            cp
+        );
+        if (hit) cp.normalA = -cp.normalA;
+    }
+
+    if (!hit) return false;
+
+    // Con circulos el manifold es siempre de un punto
+    cp.normalB = -cp.normalA;
+    m.points[0] = { cp.point, cp.penetration, 0u };
+    m.count = 1;
+    return true;
+}
+
+void CollisionManager::CullCandidates_() noexcept
+{
+    const size_t n = mNarrowCand.size();
+    mNarrowMaybe.assign(n, 1);
+
+    mBatchCC.Clear(); mBatchBC.Clear(); mBatchBB.Clear();
+    mBatchIdxCC.clear(); mBatchIdxBC.clear(); mBatchIdxBB.clear();
+
+    for (size_t k = 0; k < n; ++k)
+    {
+        const auto [refA, refB] = mNarrowCand[k];
+        const ColliderCache& ca = CacheOf_(refA);
+        const ColliderCache& cb = CacheOf_(refB);
+        const uint32_t ia = refA & ~kStaticRef;
+        const uint32_t ib = refB & ~kStaticRef;
+
+        const bool circleA = (ca.flags[ia] & ColliderCache::kCircle) != 0;
+        const bool circleB = (cb.flags[ib] & ColliderCache::kCircle) != 0;
+
+        if (circleA && circleB)
+        {
+            mBatchCC.Push(ca.center[ia].x, ca.center[ia].y, ca.radius[ia],
+                cb.center[ib].x, cb.center[ib].y, cb.radius[ib]);
+            mBatchIdxCC.push_back((uint32_t)k);
+            continue;
+        }
+
+        // Escala negativa (half < 0): directo al escalar, el filtro asume half >= 0
+        const bool negA = !circleA && (ca.half[ia].x < 0.f || ca.half[ia].y < 0.f);
+        const bool negB = !circleB && (cb.half[ib].x < 0.f || cb.half[ib].y < 0.f);
+        if (negA || negB) continue;
+
+        if (!circleA && !circleB)
+        {
+            mBatchBB.Push(ca.center[ia].x, ca.center[ia].y, ca.half[ia].x, ca.half[ia].y, ca.rot[ia].x, ca.rot[ia].y,
+                cb.center[ib].x, cb.center[ib].y, cb.half[ib].x, cb.half[ib].y, cb.rot[ib].x, cb.rot[ib].y);
+            mBatchIdxBB.push_back((uint32_t)k);
+            continue;
+        }
+
+        // Caja primero
+        const ColliderCache& box = circleA ? cb : ca;
+        const ColliderCache& cir = circleA ? ca : cb;
+        const uint32_t ib2 = circleA ? ib : ia;
+        const uint32_t ic = circleA ? ia : ib;
+        mBatchBC.Push(box.center[ib2].x, box.center[ib2].y, box.half[ib2].x, box.half[ib2].y, box.rot[ib2].x, box.rot[ib2].y,
+            cir.center[ic].x, cir.center[ic].y, cir.radius[ic]);
+        mBatchIdxBC.push_back((uint32_t)k);
+    }
+
+    auto scatter = [&](const auto& batch, const std::vector<uint32_t>& idx)
+    {
+        if (idx.empty()) return;
+        mBatchMaybe.resize(idx.size());
+        narrow::Cull(batch, mBatchMaybe.data());
+        for (size_t j = 0; j < idx.size(); ++j)
+        {
+            mNarrowMaybe[idx[j]] = mBatchMaybe[j];
+            if (!mBatchMaybe[j]) ++nNarrowCulledThisFrame;
+        }
+    };
+
+    nNarrowCulledThisFrame = 0;
+    scatter(mBatchCC, mBatchIdxCC);
+    scatter(mBatchBC, mBatchIdxBC);
+    scatter(mBatchBB, mBatchIdxBB);
+}
+
+void CollisionManager::BuildContacts_(std::vector<NarrowContact>& contacts, std::vector<NarrowContact>& triggers) noexcept
+{
+    nBroadphaseTestsThisFrame = 0;
+    nNarrowphaseTestsThisFrame = 0;
+    nTriggerTestsThisFrame = 0;
+
+    // Nueva pasada: los pares que se toquen quedan sellados con este stamp
+    ++mWorld.stamp;
+    ++nDetectionPasses;
+
+    // 0) Estaticos y orden de la lista densa: solo si cambio el conjunto
+    //    (o algun collider cambio capa/trigger: entonces se rellena toda la cache)
+    const bool refillAll = mWorld.dynamicsDirty;
+    if (mWorld.staticsDirty) BakeStatics_();
+    if (mWorld.dynamicsDirty) SortDynamics_();
+
+    // 1) Una pasada lineal: forma en mundo de cada no estatico y refit de su arbol
+    //    (solo se reinsertan los proxies que se salen de su AABB engordado).
+    //    Los de cuerpos dormidos no se mueven: si su hueco ya se relleno dormido
+    //    se deja como esta.
+    const auto& dyn = mWorld.dynamics;
+    const uint32_t n = (uint32_t)dyn.size();
+
+    mDynCache.Resize(n);
+    mDynAsleep.assign(n, 0);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        Collider2D* c = dyn[i].col;
+        const RigidBody2D* body = c->GetAttachedBody();
+        const bool asleep = body && body->IsSleeping();
+        mDynAsleep[i] = asleep ? 1 : 0;
+
+        if (asleep && !refillAll && mDynCache.col[i] == c && (mDynCache.flags[i] & ColliderCache::kAsleep))
+            continue;
+
+        mDynCache.Fill(i, c);
+        if (asleep) mDynCache.flags[i] |= ColliderCache::kAsleep;
+        TreeOf_(dyn[i].trigger, dyn[i].bucket).MoveProxy(dyn[i].proxy, mDynCache.aabb[i]);
+    }
+
+    // 2) Pares candidatos. Cada par sale una sola vez:
+    //    - solido:  arboles de solidos (rank B > rank A), de triggers y BVH estaticos
+    //    - trigger: arboles de triggers (rank B > rank A), solidos dormidos y BVH estaticos
+    //    Solo se consultan los cubos cuyas capas admite la matriz (y la mask del
+    //    collider). Static-Static no se genera nunca. Dentro de cada collider se
+    //    ordenan por referencia: orden determinista.
+    //    Los dormidos no consultan: sus pares con despiertos los saca el despierto
+    //    (aunque el rank sea menor) y dormido-dormido o dormido-estatico no se prueba.
+    //    Un trigger no busca en los arboles de solidos salvo para los dormidos: el
+    //    solido despierto ya lo encuentra a el.
+    mBroadPairs.clear();
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        if (mDynAsleep[i]) continue;
+
+        const size_t first = mBroadPairs.size();
+        const LayerBits wanted = LayerRow_(mDynCache.layer[i]) & mDynCache.mask[i];
+
+        auto queryTree = [&](const DynamicAABBTree& tree, bool all, bool onlyAsleep)
             {
-                auto oa = A->WorldOBB();
-                auto ob = B->WorldOBB();
-
-                // Ajustar nombres si la OBB no usa center/half/rotDeg
-                // Si la OBB tiene size en vez de half:
-                // Vec2 aHalf = oa.size * 0.5f;
-                // Vec2 bHalf = ob.size * 0.5f;
-
-                hit = Contact_OBB_OBB(
-                    oa.center, oa.half, oa.angleDeg,
-                    ob.center, ob.half, ob.angleDeg,
-                    cp
-                );
-            }
-            else if (sa == Collider2D::Shape::Circle && sb == Collider2D::Shape::Box)
+                tree.Query(mDynCache.aabb[i], [&](int32_t proxy)
+                    {
+                        const auto* other = static_cast<const Collider2D*>(tree.GetUserData(proxy));
+                        const bool asleep = mDynAsleep[other->broadRank_] != 0;
+                        if (onlyAsleep ? asleep : (all || other->broadRank_ > (int32_t)i || asleep))
+                            mBroadPairs.emplace_back(i, (uint32_t)other->broadRank_);
+                        return true;
+                    });
+            };
+
+        for (LayerBits used = mWorld.usedBuckets; used; used &= used - 1)
+        {
+            const int b = std::countr_zero(used);
+            if ((mWorld.bucketLayers[b] & wanted) == 0) continue;
+
+            if (dyn[i].trigger)
             {
-                auto ca = A->WorldCircle();
-                auto ob = B->WorldOBB();
-
-                // normal A->B = circle->box
-                hit = Contact_OBB_Circle(
-                    ca.center, ca.radius,
-                    ob.center, ob.half, ob.angleDeg,
-                    cp
-                );
+                queryTree(mWorld.triggerTrees[b], false, false);
+                queryTree(mWorld.trees[b], false, true);
             }
-            else if (sa == Collider2D::Shape::Box && sb == Collider2D::Shape::Circle)
+            else
             {
-                auto oa = A->WorldOBB();
-                auto cb = B->WorldCircle();
-
-                // Llamar a Circle->Box y luego invertir la normal
-                // para que quede normal A->B = box->circle
-                hit = Contact_OBB_Circle(
-                    cb.center, cb.radius,
-                    oa.center, oa.half, oa.angleDeg,
-                    cp
-                );
-                if (hit) cp.normalA = -cp.normalA;
+                queryTree(mWorld.trees[b], false, false);
+                queryTree(mWorld.triggerTrees[b], true, false);
             }
+        }
 
-            if (!hit) continue;
+        for (LayerBits used = mWorld.usedStaticBuckets; used; used &= used - 1)
+        {
+            const int b = std::countr_zero(used);
+            if ((mWorld.staticBucketLayers[b] & wanted) == 0) continue;
+
+            mWorld.statics[b].Query(mDynCache.aabb[i], [&](uint32_t item)
+                {
+                    mBroadPairs.emplace_back(i, item | kStaticRef);
+                    return true;
+                });
+        }
 
-            NarrowContact nc;
+        std::sort(mBroadPairs.begin() + first, mBroadPairs.end());
+    }
 
-            auto* bodyA = A->GetAttachedBody();
-            auto* bodyB = B->GetAttachedBody();
+    // 3) Filtro (capas, mismo cuerpo) y AABB exacto. Los pares con algun trigger van
+    //    aparte: no necesitan manifold ni entran en el solver
+    mNarrowCand.clear();
+    mTriggerCand.clear();
+    for (const auto& [rank, ref] : mBroadPairs)
+    {
+        // A = menor (ID, puntero), como en el recorrido i < j de siempre
+        uint32_t refA = rank;
+        uint32_t refB = ref;
+        const ColliderCache* ca = &mDynCache;
+        const ColliderCache* cb = &CacheOf_(refB);
+        uint32_t ia = refA;
+        uint32_t ib = refB & ~kStaticRef;
+        if (cb->id[ib] < ca->id[ia] || (cb->id[ib] == ca->id[ia] && cb->col[ib] < ca->col[ia]))
+        {
+            std::swap(ca, cb);
+            std::swap(ia, ib);
+            std::swap(refA, refB);
+        }
 
-            GameObject* ownerA = bodyA ? bodyA->gameObject : A->mGameObject;
-            GameObject* ownerB = bodyB ? bodyB->gameObject : B->mGameObject;
+        // El cubo solo descarta por capas agrupadas: matriz y mask exactas por par
+        // (en ambos sentidos, igual que las consultas de cada lado)
+        if ((LayerRow_(ca->layer[ia]) & ca->mask[ia] & cb->layer[ib]) == 0) continue;
+        if ((LayerRow_(cb->layer[ib]) & cb->mask[ib] & ca->layer[ia]) == 0) continue;
+        if (!ShouldTest(*ca, ia, *cb, ib)) continue;
 
-            if (!ownerA || !ownerB) continue;
-            if (ownerA == ownerB) continue; // misma entidad fsica
+        // Broadphase exacto (AABB reales, el arbol usa los engordados)
+        nBroadphaseTestsThisFrame++;
+        if (!TestBoxBox(ca->aabb[ia], cb->aabb[ib])) continue;
 
-            nc.a = ownerA;
-            nc.b = ownerB;
-            nc.colA = A;
-            nc.colB = B;
-            nc.isTriggerPair = A->GetIsTrigger() || B->GetIsTrigger();
-            nc.contact = cp;
+        if ((ca->flags[ia] | cb->flags[ib]) & ColliderCache::kTrigger)
+            mTriggerCand.emplace_back(refA, refB);
+        else
+            mNarrowCand.emplace_back(refA, refB);
+    }
 
-            out.emplace_back(nc);
-            const uint64_t key = MakeKey_(nc.a->GetID(), nc.b->GetID());
-            mCurrPairs.insert(key);
+    // 4) Triggers: test booleano de solape, sin contacto
+    TriggerOverlaps_(triggers);
 
-            mCurrInfo[key] = PairInfo{
-                nc.a, nc.b,
-                nc.colA, nc.colB,
-                nc.isTriggerPair
-            };
+    // 5) Descarte por lotes segun combinacion de formas (SIMD)
+    CullCandidates_();
+
+    // 6) Narrowphase escalar sobre los que quedan, repartido en tramos entre hilos.
+    //    Se junta en orden de tramo: contactos y tabla de pares salen igual que en serie.
+    const size_t nc = mNarrowCand.size();
+    JobSystem* jobs = JobSystem::GetInstancePtr_NO_ERROR_MSG();
+    const size_t threads = jobs ? jobs->GetThreadCount() : 1;
+
+    size_t jobCount = (threads > 1) ? std::min(threads * kNarrowJobsPerThread, nc / kMinPairsPerNarrowJob) : 1;
+    if (jobCount < 1) jobCount = 1;
+
+    if (mNarrowJobs.size() < jobCount) mNarrowJobs.resize(jobCount);
+    nNarrowJobsThisFrame = (int)jobCount;
+
+    if (jobCount == 1)
+    {
+        NarrowRange_(0, nc, mNarrowJobs[0]);
+    }
+    else
+    {
+        jobs->ParallelFor((uint32_t)jobCount, [&](uint32_t j)
+            {
+                NarrowRange_(nc * j / jobCount, nc * (j + 1) / jobCount, mNarrowJobs[j]);
+            });
+    }
+
+    // 7) Merge en serie: salida y sellado de pares en la tabla persistente
+    for (size_t j = 0; j < jobCount; ++j)
+    {
+        NarrowJob& job = mNarrowJobs[j];
+        nNarrowphaseTestsThisFrame += job.tests;
+
+        for (const NarrowContact& c : job.contacts)
+        {
+            contacts.push_back(c);
+            TouchPair_(c);
         }
     }
 }
 
+bool CollisionManager::ResolveOwners_(const ColliderCache& ca, uint32_t ia, const ColliderCache& cb, uint32_t ib, NarrowContact& nc) const noexcept
+{
+    RigidBody2D* bodyA = ca.body[ia];
+    RigidBody2D* bodyB = cb.body[ib];
+
+    GameObject* ownerA = bodyA ? bodyA->gameObject : ca.go[ia];
+    GameObject* ownerB = bodyB ? bodyB->gameObject : cb.go[ib];
+
+    if (!ownerA || !ownerB) return false;
+    if (ownerA == ownerB) return false; // misma entidad fisica
+
+    nc.a = ownerA;
+    nc.b = ownerB;
+    nc.colA = ca.col[ia];
+    nc.colB = cb.col[ib];
+    nc.bodyA = bodyA;
+    nc.bodyB = bodyB;
+    nc.centerA = ca.center[ia];
+    nc.centerB = cb.center[ib];
+    nc.isTriggerPair = ((ca.flags[ia] | cb.flags[ib]) & ColliderCache::kTrigger) != 0;
+    return true;
+}
+
+void CollisionManager::TouchPair_(const NarrowContact& c) noexcept
+{
+    bool inserted = false;
+    PairTable::Pair& pair = mWorld.pairs.Touch(MakeKey_(c.a->GetID(), c.b->GetID()), inserted);
+
+    // El par es por GameObject: varios colliders del mismo objeto (p.ej. los rectangulos
+    // de un Tilemap) caen en el mismo registro. Dentro de una pasada se queda el
+    // contacto mas profundo, no el ultimo que llega.
+    if (!inserted && pair.stamp == mWorld.stamp && pair.isTriggerPair == c.isTriggerPair
+        && c.contact.penetration <= pair.contact.penetration)
+        return;
+
+    if (inserted)
+    {
+        LinkPair_(c.colA, pair.key);
+        LinkPair_(c.colB, pair.key);
+    }
+    else if (!((pair.colA == c.colA && pair.colB == c.colB) || (pair.colA == c.colB && pair.colB == c.colA)))
+    {
+        // Otro collider del mismo GameObject pasa a ser el del par
+        if (pair.colA != c.colA && pair.colA != c.colB) UnlinkPair_(pair.colA, pair.key);
+        if (pair.colB != c.colA && pair.colB != c.colB) UnlinkPair_(pair.colB, pair.key);
+        if (c.colA != pair.colA && c.colA != pair.colB) LinkPair_(c.colA, pair.key);
+        if (c.colB != pair.colA && c.colB != pair.colB) LinkPair_(c.colB, pair.key);
+    }
+    pair.a = c.a;
+    pair.b = c.b;
+    pair.colA = c.colA;
+    pair.colB = c.colB;
+    pair.bodyA = c.bodyA;
+    pair.bodyB = c.bodyB;
+    pair.isTriggerPair = c.isTriggerPair;
+    pair.contact = c.contact;
+    pair.stamp = mWorld.stamp;
+}
+
+void CollisionManager::TriggerOverlaps_(std::vector<NarrowContact>& triggers) noexcept
+{
+    for (const auto& [refA, refB] : mTriggerCand)
+    {
+        const ColliderCache& ca = CacheOf_(refA);
+        const ColliderCache& cb = CacheOf_(refB);
+        const uint32_t ia = refA & ~kStaticRef;
+        const uint32_t ib = refB & ~kStaticRef;
+
+        nTriggerTestsThisFrame++;
+        if (!Overlap_(ca, ia, cb, ib)) continue;
+
+        NarrowContact nc;   // contact queda a cero: los eventos de trigger no lo llevan
+        if (!ResolveOwners_(ca, ia, cb, ib, nc)) continue;
+
+        triggers.push_back(nc);
+        TouchPair_(nc);
+    }
+}
+
+void CollisionManager::NarrowRange_(size_t begin, size_t end, NarrowJob& job) noexcept
+{
+    job.contacts.clear();
+    job.tests = 0;
+
+    for (size_t k = begin; k < end; ++k)
+    {
+        if (!mNarrowMaybe[k]) continue;
+
+        const auto [refA, refB] = mNarrowCand[k];
+        const ColliderCache& ca = CacheOf_(refA);
+        const ColliderCache& cb = CacheOf_(refB);
+        const uint32_t ia = refA & ~kStaticRef;
+        const uint32_t ib = refB & ~kStaticRef;
+
+        // Narrow + ContactPoint
+        job.tests++;
+
+        NarrowContact nc;
+        if (!Narrow_(ca, ia, cb, ib, nc.contact, nc.manifold)) continue;
+        if (!ResolveOwners_(ca, ia, cb, ib, nc)) continue;
+
+        job.contacts.emplace_back(nc);
+    }
+}
+
+void CollisionManager::LinkPair_(Collider2D* c, uint64_t key) noexcept
+{
+    if (c) c->pairKeys_.push_back(key);
+}
+
+void CollisionManager::UnlinkPair_(Collider2D* c, uint64_t key) noexcept
+{
+    if (!c) return;
+    auto& keys = c->pairKeys_;
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        if (keys[i] != key) continue;
+        keys[i] = keys.back();
+        keys.pop_back();
+        return;
+    }
+}
+
+void CollisionManager::WakePairsOf_(const Collider2D* c) noexcept
+{
+    ForEachPairOf_(c, [](PairTable::Pair& p)
+        {
+            if (p.bodyA && p.bodyA->IsSleeping()) p.bodyA->WakeUp();
+            if (p.bodyB && p.bodyB->IsSleeping()) p.bodyB->WakeUp();
+        });
+}
+
+void CollisionManager::ForgetBody_(const RigidBody2D* b) noexcept
+{
+    // Sus pares solo pueden venir de los colliders de su GameObject y de los hijos
+    // que no tienen cuerpo propio: se recorren sus claves, no toda la tabla
+    auto forget = [&](auto& self, GameObject* go) -> void
+        {
+            for (Collider2D* c : go->GetComponents<Collider2D>())
+                ForEachPairOf_(c, [&](PairTable::Pair& p)
+                    {
+                        if (p.bodyA == b) p.bodyA = nullptr;
+                        if (p.bodyB == b) p.bodyB = nullptr;
+                        // El otro lado pierde lo que tenia encima o debajo
+                        if (p.bodyA && p.bodyA->IsSleeping()) p.bodyA->WakeUp();
+                        if (p.bodyB && p.bodyB->IsSleeping()) p.bodyB->WakeUp();
+                    });
+            for (GameObject* child : go->Children())
+                if (child && !child->GetComponent<RigidBody2D>()) self(self, child);
+        };
+    if (GameObject* go = b->gameObject) forget(forget, go);
+}
+
+// Lado que no se mueve: cuerpo dormido o collider estatico
+bool CollisionManager::AtRest_(const RigidBody2D* body, const Collider2D* col) noexcept
+{
+    if (body && body->IsSleeping()) return true;
+    return col && col->ResolveBodyClass() == Collider2D::BodyClass::Static;
+}
+
 static inline ContactPoint FlipContactForB_(const ContactPoint& cp) noexcept
 {
     ContactPoint out = cp;
@@ -513,118 +1226,173 @@ static inline ContactPoint FlipContactForB_(const ContactPoint& cp) noexcept
     return out;
 }
 
-void CollisionManager::Dispatch_(const std::vector<NarrowContact>& contacts) noexcept
+void CollisionManager::Dispatch_(const std::vector<NarrowContact>& contacts, const std::vector<NarrowContact>& triggers) noexcept
 {
-    // --------------- ENTER / STAY ---------------
-    for (const auto& c : contacts)
-    {
-        if (!c.a || !c.b) continue;
-
-        const uint64_t key = MakeKey_(c.a->GetID(), c.b->GetID());
-        const bool was = (mPrevPairs.find(key) != mPrevPairs.end());
-
-        CollisionInfo2D infoAB;
-        infoAB.self = c.a;
-        infoAB.other = c.b;
-        infoAB.selfCollider = c.colA;
-        infoAB.otherCollider = c.colB;
-        infoAB.contacts.clear();
-
-        CollisionInfo2D infoBA;
-        infoBA.self = c.b;
-        infoBA.other = c.a;
-        infoBA.selfCollider = c.colB;
-        infoBA.otherCollider = c.colA;
-        infoBA.contacts.clear();
-
-        if (!c.isTriggerPair) {
-            infoAB.contacts.push_back(c.contact);
-            infoBA.contacts.push_back(FlipContactForB_(c.contact));
-        }
+    // Los eventos se encolan (solo para objetos con algun Behaviour que los escuche),
+    // se agrupan por receptor y se entregan al final: sin memoria dinamica por contacto
+    // (mEvents conserva su capacidad) y los callbacks no ven la tabla a medias.
+    mEvents.clear();
 
-        if (c.isTriggerPair)
+    auto push = [&](GameObject* self, GameObject* other, Collider2D* selfCol, Collider2D* otherCol,
+        uint8_t hook, const ContactList* cl)
         {
-            if (!was) { c.a->OnTriggerEnter(infoAB); c.b->OnTriggerEnter(infoBA); }
-            else { c.a->OnTriggerStay(infoAB);  c.b->OnTriggerStay(infoBA); }
-        }
-        else
+            if ((self->mListenerHooks & hook) == 0) return;
+
+            CollisionEvent2D& ev = mEvents.emplace_back();
+            ev.hook = hook;
+            ev.seq = (uint32_t)mEvents.size() - 1;
+            ev.info.self = self;
+            ev.info.other = other;
+            ev.info.selfCollider = selfCol;
+            ev.info.otherCollider = otherCol;
+            if (cl) ev.info.contacts = *cl;
+        };
+
+    // --------------- ENTER / STAY ---------------
+    // Primero los contactos solidos y despues los solapes de trigger
+    for (const std::vector<NarrowContact>* list : { &contacts, &triggers })
+    {
+        for (const auto& c : *list)
         {
-            if (!was) { c.a->OnCollisionEnter(infoAB); c.b->OnCollisionEnter(infoBA); }
-            else { c.a->OnCollisionStay(infoAB);  c.b->OnCollisionStay(infoBA); }
+            if (!c.a || !c.b) continue;
+
+            PairTable::Pair* pair = mWorld.pairs.Find(MakeKey_(c.a->GetID(), c.b->GetID()));
+            const bool was = pair && pair->touching;
+            // Un solo Enter por par de GameObjects: los demas contactos del par en
+            // este dispatch (otro collider del mismo objeto) llegan como Stay
+            if (pair) pair->touching = true;
+
+            // Un trigger que entra despierta al dormido, como lo haria un contacto
+            if (c.isTriggerPair && !was)
+            {
+                if (c.bodyA && c.bodyA->IsSleeping()) c.bodyA->WakeUp();
+                if (c.bodyB && c.bodyB->IsSleeping()) c.bodyB->WakeUp();
+            }
+
+            uint8_t hook;
+            if (c.isTriggerPair) hook = was ? GameObject::kTriggerStay : GameObject::kTriggerEnter;
+            else hook = was ? GameObject::kCollisionStay : GameObject::kCollisionEnter;
+
+            if (((c.a->mListenerHooks | c.b->mListenerHooks) & hook) == 0) continue;
+
+            if (c.isTriggerPair)
+            {
+                push(c.a, c.b, c.colA, c.colB, hook, nullptr);
+                push(c.b, c.a, c.colB, c.colA, hook, nullptr);
+            }
+            else
+            {
+                // Un ContactPoint por punto del manifold (normal comun del par)
+                ContactList listA, listB;
+                for (const ManifoldPoint& mp : c.manifold)
+                {
+                    ContactPoint cp = c.contact;
+                    cp.point = mp.point;
+                    cp.penetration = mp.penetration;
+                    listA.push_back(cp);
+                    listB.push_back(FlipContactForB_(cp));
+                }
+                if (listA.empty())
+                {
+                    listA.push_back(c.contact);
+                    listB.push_back(FlipContactForB_(c.contact));
+                }
+
+                push(c.a, c.b, c.colA, c.colB, hook, &listA);
+                push(c.b, c.a, c.colB, c.colA, hook, &listB);
+            }
         }
     }
 
     // --------------- EXIT ---------------
-    // Para cada par que estaba antes pero ya no est ahora:
-    for (const auto& [key, prev] : mPrevInfo)
-    {
-        if (mCurrPairs.find(key) != mCurrPairs.end())
-            continue;
+    // Pares en contacto en el dispatch anterior que no se han tocado en esta pasada.
+    // Los que no se tocan se quitan de la tabla; el resto pasa a touching.
+    const uint32_t stamp = mWorld.stamp;
+    nActivePairs = 0;
+    mPairErase.clear();
 
-        if (!prev.a || !prev.b)
-            continue;
-
-        CollisionInfo2D ab;
-        ab.self = prev.a;
-        ab.other = prev.b;
-        ab.selfCollider = prev.colA;
-        ab.otherCollider = prev.colB;
-        ab.contacts.clear();
-
-        CollisionInfo2D ba;
-        ba.self = prev.b;
-        ba.other = prev.a;
-        ba.selfCollider = prev.colB;
-        ba.otherCollider = prev.colA;
-        ba.contacts.clear();
-
-        if (prev.isTriggerPair)
+    mWorld.pairs.ForEach([&](PairTable::Pair& p)
         {
-            prev.a->OnTriggerExit(ab);
-            prev.b->OnTriggerExit(ba);
-        }
-        else
+            if (p.stamp == stamp)
+            {
+                p.touching = true;
+                ++nActivePairs;
+                return;
+            }
+
+            // Dormido contra dormido/estatico: no se ha probado, sigue en contacto
+            // (sin Stay, como cualquier cuerpo dormido)
+            if (p.touching && AtRest_(p.bodyA, p.colA) && AtRest_(p.bodyB, p.colB))
+            {
+                ++nActivePairs;
+                return;
+            }
+
+            if (p.touching && p.a && p.b)
+            {
+                const uint8_t hook = p.isTriggerPair ? GameObject::kTriggerExit : GameObject::kCollisionExit;
+                push(p.a, p.b, p.colA, p.colB, hook, nullptr);
+                push(p.b, p.a, p.colB, p.colA, hook, nullptr);
+            }
+
+            UnlinkPair_(p.colA, p.key);
+            UnlinkPair_(p.colB, p.key);
+            mPairErase.push_back(p.key);
+        });
+
+    for (uint64_t key : mPairErase) mWorld.pairs.Erase(key);
+
+    // --------------- ENTREGA ---------------
+    // Por receptor (ID) y, dentro de cada uno, en el orden en que se generaron
+    nEventsThisFrame = mEvents.size();
+    std::sort(mEvents.begin(), mEvents.end(), [](const CollisionEvent2D& x, const CollisionEvent2D& y)
         {
-            prev.a->OnCollisionExit(ab);
-            prev.b->OnCollisionExit(ba);
-        }
+            const EntityID ix = x.info.self->GetID(), iy = y.info.self->GetID();
+            return (ix != iy) ? ix < iy : x.seq < y.seq;
+        });
+
+    for (size_t i = 0; i < mEvents.size(); )
+    {
+        size_t j = i + 1;
+        while (j < mEvents.size() && mEvents[j].info.self == mEvents[i].info.self) ++j;
+
+        mEvents[i].info.self->DeliverCollisionEvents_(&mEvents[i], j - i);
+        i = j;
     }
 }
 
 // =================== Narrow-phase ===================
 
-bool CollisionManager::TestOBB_OBB(const Collider2D::OrientedBox2D& A,
-    const Collider2D::OrientedBox2D& B) noexcept {
+bool CollisionManager::TestOBB_OBB(const Vec2& ac, const Vec2& aHalf, const Vec2& aRot,
+    const Vec2& bc, const Vec2& bHalf, const Vec2& bRot) noexcept {
     // SAT con 4 ejes: ejes locales de A y de B
-    Vec2 Ax, Ay, Bx, By;
-    BuildAxes(A.angleDeg, Ax, Ay);
-    BuildAxes(B.angleDeg, Bx, By);
+    const Basis2 A = OBBBases(aRot);
+    const Basis2 B = OBBBases(bRot);
+
+    // Escala negativa: solo importa el tamano
+    const Vec2 ah = { std::fabs(aHalf.x), std::fabs(aHalf.y) };
+    const Vec2 bh = { std::fabs(bHalf.x), std::fabs(bHalf.y) };
 
-    const Vec2 T = { B.center.x - A.center.x, B.center.y - A.center.y };
+    const Vec2 T = bc - ac;
 
     // Proyecta centros
-    const float T_Ax = math::Dot(T, Ax);
-    const float T_Ay = math::Dot(T, Ay);
-    const float T_Bx = math::Dot(T, Bx);
-    const float T_By = math::Dot(T, By);
+    const float T_Ax = math::Dot(T, A.x);
+    const float T_Ay = math::Dot(T, A.y);
+    const float T_Bx = math::Dot(T, B.x);
+    const float T_By = math::Dot(T, B.y);
 
     // Componentes del radio proyectadas
-    const float Ra_Ax = A.half.x;    // proyeccin de A en su propio eje Ax
-    const float Ra_Ay = A.half.y;    // en Ay
+    const float Rb_Ax = bh.x * AbsDot(B.x, A.x) + bh.y * AbsDot(B.y, A.x);
+    const float Rb_Ay = bh.x * AbsDot(B.x, A.y) + bh.y * AbsDot(B.y, A.y);
 
-    const float Rb_Ax = B.half.x * AbsDot(Bx, Ax) + B.half.y * AbsDot(By, Ax);
-    const float Rb_Ay = B.half.x * AbsDot(Bx, Ay) + B.half.y * AbsDot(By, Ay);
-
-    const float Ra_Bx = A.half.x * AbsDot(Ax, Bx) + A.half.y * AbsDot(Ay, Bx);
-    const float Ra_By = A.half.x * AbsDot(Ax, By) + A.half.y * AbsDot(Ay, By);
-    const float Rb_Bx = B.half.x;
-    const float Rb_By = B.half.y;
+    const float Ra_Bx = ah.x * AbsDot(A.x, B.x) + ah.y * AbsDot(A.y, B.x);
+    const float Ra_By = ah.x * AbsDot(A.x, B.y) + ah.y * AbsDot(A.y, B.y);
 
     // Test en 4 ejes
-    if (!Overlap1D(0.f, Ra_Ax, T_Ax, Rb_Ax)) return false;
-    if (!Overlap1D(0.f, Ra_Ay, T_Ay, Rb_Ay)) return false;
-    if (!Overlap1D(0.f, Ra_Bx, T_Bx, Rb_Bx)) return false;
-    if (!Overlap1D(0.f, Ra_By, T_By, Rb_By)) return false;
+    if (!Overlap1D(0.f, ah.x, T_Ax, Rb_Ax)) return false;
+    if (!Overlap1D(0.f, ah.y, T_Ay, Rb_Ay)) return false;
+    if (!Overlap1D(0.f, Ra_Bx, T_Bx, bh.x)) return false;
+    if (!Overlap1D(0.f, Ra_By, T_By, bh.y)) return false;
 
     return true;
 }
@@ -635,24 +1403,568 @@ bool CollisionManager::TestCircle_Circle(const Vec2& ca, float ra,
     return math::LengthSq(cb - ca) <= (r * r);
 }
 
-bool CollisionManager::TestOBB_Circle(const Collider2D::OrientedBox2D& box,
+bool CollisionManager::TestOBB_Circle(const Vec2& bc, const Vec2& half, const Vec2& rot,
     const Vec2& cc, float r) noexcept {
-    // Lleva el crculo al espacio local del box
-    const float rad = box.angleDeg * 3.14159265358979323846f / 180.f;
-    const float c = std::cos(-rad), s = std::sin(-rad);
-    const Vec2 rel = { cc.x - box.center.x, cc.y - box.center.y };
-    const Vec2 pLocal = { c * rel.x - s * rel.y, s * rel.x + c * rel.y };
+    // Lleva el circulo al espacio local del box
+    const Vec2 pLocal = WorldToLocal(cc, bc, OBBBases(rot));
 
-    // Punto ms cercano en el rect local [-half..half]
-    const float qx = std::clamp(pLocal.x, -box.half.x, box.half.x);
-    const float qy = std::clamp(pLocal.y, -box.half.y, box.half.y);
+    // Punto mas cercano en el rect local [-half..half]
+    const float hx = std::fabs(half.x), hy = std::fabs(half.y);
+    const float qx = ClampF(pLocal.x, -hx, hx);
+    const float qy = ClampF(pLocal.y, -hy, hy);
 
     const Vec2 diff = { pLocal.x - qx, pLocal.y - qy };
     return math::LengthSq(diff) <= r * r;
 }
 
+bool CollisionManager::Overlap_(const ColliderCache& ca, uint32_t ia, const ColliderCache& cb, uint32_t ib) noexcept
+{
+    const bool circleA = (ca.flags[ia] & ColliderCache::kCircle) != 0;
+    const bool circleB = (cb.flags[ib] & ColliderCache::kCircle) != 0;
+
+    if (circleA && circleB)
+        return TestCircle_Circle(ca.center[ia], ca.radius[ia], cb.center[ib], cb.radius[ib]);
+
+    if (!circleA && !circleB)
+        return TestOBB_OBB(ca.center[ia], ca.half[ia], ca.rot[ia], cb.center[ib], cb.half[ib], cb.rot[ib]);
+
+    if (circleA)
+        return TestOBB_Circle(cb.center[ib], cb.half[ib], cb.rot[ib], ca.center[ia], ca.radius[ia]);
+
+    return TestOBB_Circle(ca.center[ia], ca.half[ia], ca.rot[ia], cb.center[ib], cb.radius[ib]);
+}
+
 // =================== Broad-phase ===================
 
 bool CollisionManager::TestBoxBox(const Rect& a, const Rect& b) noexcept {
     return a.Overlaps(b);
-}
\ No newline at end of file
+}
+
+// =================== Consultas ===================
+
+// Rayo origin + dir * t (dir unitaria) contra circulo. Origen dentro => t = 0
+static bool RayCircle_(const Vec2& o, const Vec2& d, const Vec2& c, float r, float maxT, float& t, Vec2& n) noexcept
+{
+    const Vec2 m = o - c;
+    const float b = math::Dot(m, d);
+    const float cc = math::Dot(m, m) - r * r;
+
+    if (cc <= 0.f) { t = 0.f; n = -d; return true; }
+    if (b > 0.f) return false;                  // fuera y alejandose
+
+    const float disc = b * b - cc;
+    if (disc < 0.f) return false;
+
+    t = -b - std::sqrt(disc);
+    if (t > maxT) return false;
+    if (t < 0.f) t = 0.f;
+
+    n = NormalizeSafe(o + d * t - c, -d);
+    return true;
+}
+
+// Rayo contra la OBB engordada r (Minkowski caja + circulo). r = 0: rayo contra OBB
+static bool RayRoundedBox_(const Vec2& o, const Vec2& d, const Vec2& bc, const Vec2& halfIn, const Vec2& rot,
+    float r, float maxT, float& t, Vec2& n) noexcept
+{
+    const Basis2 b = OBBBases(rot);
+    const Vec2 h = { std::fabs(halfIn.x), std::fabs(halfIn.y) };
+    const Vec2 ol = WorldToLocal(o, bc, b);
+    const Vec2 dl = { math::Dot(d, b.x), math::Dot(d, b.y) };
+
+    // Origen dentro
+    const Vec2 q = ClampV(ol, { -h.x, -h.y }, h);
+    if (math::LengthSq(ol - q) <= r * r) { t = 0.f; n = -d; return true; }
+
+    // Slabs de la caja engordada
+    const float o2[2] = { ol.x, ol.y };
+    const float d2[2] = { dl.x, dl.y };
+    const float e2[2] = { h.x + r, h.y + r };
+
+    float tEnter = -FLT_MAX, tExit = FLT_MAX;
+    int axis = -1;
+    for (int k = 0; k < 2; ++k)
+    {
+        if (std::fabs(d2[k]) < 1e-12f)
+        {
+            if (std::fabs(o2[k]) > e2[k]) return false;
+            continue;
+        }
+
+        float t1 = (-e2[k] - o2[k]) / d2[k];
+        float t2 = (e2[k] - o2[k]) / d2[k];
+        if (t1 > t2) std::swap(t1, t2);
+        if (t1 > tEnter) { tEnter = t1; axis = k; }
+        tExit = std::min(tExit, t2);
+        if (tEnter > tExit) return false;
+    }
+    if (tExit < 0.f) return false;
+
+    // Esquina: la parte redondeada es el circulo de radio r en el vertice
+    const Vec2 p = ol + dl * std::max(tEnter, 0.f);
+    Vec2 nl;
+    if (r > 0.f && std::fabs(p.x) > h.x && std::fabs(p.y) > h.y)
+    {
+        const Vec2 corner = { p.x > 0.f ? h.x : -h.x, p.y > 0.f ? h.y : -h.y };
+        if (!RayCircle_(ol, dl, corner, r, maxT, t, nl)) return false;
+    }
+    else
+    {
+        if (axis < 0 || tEnter > maxT) return false;
+        t = tEnter;
+        nl = (axis == 0) ? Vec2{ dl.x > 0.f ? -1.f : 1.f, 0.f } : Vec2{ 0.f, dl.y > 0.f ? -1.f : 1.f };
+    }
+
+    n = b.x * nl.x + b.y * nl.y;
+    return true;
+}
+
+// Caja A que se mueve a lo largo de d contra caja B: SAT con intervalos de tiempo
+// por eje (exacto para dos rectangulos)
+static bool SweepBoxBox_(const Vec2& ca, const Vec2& ha, const Vec2& rotA, const Vec2& d,
+    const Vec2& cb, const Vec2& hb, const Vec2& rotB, float maxT, float& t, Vec2& n, Vec2& point) noexcept
+{
+    const Basis2 A = OBBBases(rotA);
+    const Basis2 B = OBBBases(rotB);
+    const Vec2 axes[4] = { A.x, A.y, B.x, B.y };
+    const Vec2 ah = { std::fabs(ha.x), std::fabs(ha.y) };
+    const Vec2 bh = { std::fabs(hb.x), std::fabs(hb.y) };
+    const Vec2 T = cb - ca;
+
+    float tEnter = -FLT_MAX, tExit = FLT_MAX;
+    Vec2 enterAxis = -d;
+    for (const Vec2& ax : axes)
+    {
+        const float ra = ah.x * AbsDot(A.x, ax) + ah.y * AbsDot(A.y, ax);
+        const float rb = bh.x * AbsDot(B.x, ax) + bh.y * AbsDot(B.y, ax);
+        const float s = math::Dot(T, ax);
+        const float v = math::Dot(d, ax);
+        const float rs = ra + rb;
+
+        // |s - v t| <= rs
+        if (std::fabs(v) < 1e-12f)
+        {
+            if (std::fabs(s) > rs) return false;
+            continue;
+        }
+
+        float t1 = (s - rs) / v;
+        float t2 = (s + rs) / v;
+        if (t1 > t2) std::swap(t1, t2);
+        if (t1 > tEnter)
+        {
+            tEnter = t1;
+            enterAxis = (v > 0.f) ? -ax : ax;   // de B hacia A
+        }
+        tExit = std::min(tExit, t2);
+        if (tEnter > tExit) return false;
+    }
+    if (tExit < 0.f || tEnter > maxT) return false;
+
+    if (tEnter <= 0.f) { t = 0.f; n = -d; }
+    else { t = tEnter; n = enterAxis; }
+
+    // Punto: vertice de A mas metido hacia B en el instante del impacto
+    const float sx = (math::Dot(A.x, n) > 0.f) ? -ah.x : ah.x;
+    const float sy = (math::Dot(A.y, n) > 0.f) ? -ah.y : ah.y;
+    point = ca + d * t + A.x * sx + A.y * sy;
+    return true;
+}
+
+bool CollisionManager::CastShape_(const QueryShape_& s, const Vec2& dir, float maxT, const QueryShape_& target,
+    float& t, Vec2& normal, Vec2& point) noexcept
+{
+    if (s.circle)
+    {
+        // Rayo (radio 0) o circulo: rayo desde el centro contra el objetivo engordado
+        if (target.circle)
+        {
+            if (!RayCircle_(s.center, dir, target.center, target.radius + s.radius, maxT, t, normal)) return false;
+        }
+        else
+        {
+            if (!RayRoundedBox_(s.center, dir, target.center, target.half, target.rot, s.radius, maxT, t, normal)) return false;
+        }
+        point = s.center + dir * t - normal * s.radius;
+        return true;
+    }
+
+    if (!target.circle)
+        return SweepBoxBox_(s.center, s.half, s.rot, dir, target.center, target.half, target.rot, maxT, t, normal, point);
+
+    // Caja contra circulo = el circulo se mueve al reves contra la caja engordada
+    Vec2 nBox;
+    if (!RayRoundedBox_(target.center, -dir, s.center, s.half, s.rot, target.radius, maxT, t, nBox)) return false;
+    normal = (t > 0.f) ? -nBox : -dir;
+    point = target.center + normal * target.radius;
+    return true;
+}
+
+CollisionManager::QueryShape_ CollisionManager::ShapeOf_(Collider2D* c) noexcept
+{
+    // Dentro de PhysicsManager::Step (CCD) la pose de los cuerpos va por delante del Transform
+    const auto* physics = PhysicsManager::GetInstancePtr_NO_ERROR_MSG();
+    const Collider2D::WorldShape ws = (physics && physics->mInStep)
+        ? CacheShapeOf_(c, c->GetAttachedBody())
+        : c->ComputeWorldShape();
+
+    QueryShape_ s;
+    s.col = c;
+    s.circle = c->shape_ == Collider2D::Shape::Circle;
+    s.center = ws.center;
+    s.half = ws.half;
+    s.rot = ws.rot;
+    s.radius = ws.radius;
+    s.aabb = ws.aabb;
+    return s;
+}
+
+CollisionManager::QueryShape_ CollisionManager::StaticShapeOf_(uint32_t item) const noexcept
+{
+    const ColliderCache& sc = mWorld.staticCache;
+
+    QueryShape_ s;
+    s.col = sc.col[item];
+    s.circle = (sc.flags[item] & ColliderCache::kCircle) != 0;
+    s.center = sc.center[item];
+    s.half = sc.half[item];
+    s.rot = sc.rot[item];
+    s.radius = sc.radius[item];
+    s.aabb = sc.aabb[item];
+    return s;
+}
+
+CollisionManager::QueryShape_ CollisionManager::MakeQueryBox_(const Vec2& center, const Vec2& size, float angleDeg) noexcept
+{
+    QueryShape_ s;
+    s.circle = false;
+    s.center = center;
+    s.half = { std::fabs(size.x) * 0.5f, std::fabs(size.y) * 0.5f };
+
+    const float a = DegToRad(angleDeg);
+    s.rot = { std::cos(a), std::sin(a) };
+
+    const float ex = std::fabs(s.rot.x * s.half.x) + std::fabs(s.rot.y * s.half.y);
+    const float ey = std::fabs(s.rot.y * s.half.x) + std::fabs(s.rot.x * s.half.y);
+    s.aabb = { center.x - ex, center.y - ey, ex * 2.f, ey * 2.f };
+    return s;
+}
+
+void CollisionManager::PrepareQueries_() noexcept
+{
+    // Mismo estado que veria la siguiente pasada de deteccion
+    if (mWorld.staticsDirty) BakeStatics_();
+    if (mWorld.dynamicsDirty) SortDynamics_();
+}
+
+bool CollisionManager::AcceptQuery_(const Collider2D* c, const QueryFilter2D& filter) const noexcept
+{
+    if (!c || !c->mGameObject) return false;
+    if ((c->layer_ & filter.mask) == 0) return false;
+    if (c->isTrigger_ && !filter.hitTriggers) return false;
+    return true;
+}
+
+template<class F>
+void CollisionManager::QueryShapes_(const Rect& aabb, const QueryFilter2D& filter, F&& callback) noexcept
+{
+    bool stop = false;
+
+    auto visitTree = [&](const DynamicAABBTree& tree)
+        {
+            tree.Query(aabb, [&](int32_t proxy)
+                {
+                    Collider2D* c = static_cast<Collider2D*>(tree.GetUserData(proxy));
+                    if (!AcceptQuery_(c, filter)) return true;
+
+                    const QueryShape_ s = ShapeOf_(c);
+                    if (!s.aabb.Overlaps(aabb)) return true;
+
+                    stop = !callback(s);
+                    return !stop;
+                });
+        };
+
+    for (LayerBits used = mWorld.usedBuckets; used && !stop; used &= used - 1)
+    {
+        const int b = std::countr_zero(used);
+        if ((mWorld.bucketLayers[b] & filter.mask) == 0) continue;
+
+        visitTree(mWorld.trees[b]);
+        if (filter.hitTriggers && !stop) visitTree(mWorld.triggerTrees[b]);
+    }
+
+    for (LayerBits used = mWorld.usedStaticBuckets; used && !stop; used &= used - 1)
+    {
+        const int b = std::countr_zero(used);
+        if ((mWorld.staticBucketLayers[b] & filter.mask) == 0) continue;
+
+        mWorld.statics[b].Query(aabb, [&](uint32_t item)
+            {
+                if (!AcceptQuery_(mWorld.staticCache.col[item], filter)) return true;
+                stop = !callback(StaticShapeOf_(item));
+                return !stop;
+            });
+    }
+}
+
+template<class F>
+void CollisionManager::RayCastShapes_(const Vec2& origin, const Vec2& dir, float maxT, const QueryFilter2D& filter, F&& callback) noexcept
+{
+    auto visitTree = [&](const DynamicAABBTree& tree)
+        {
+            tree.RayCast(origin, dir, maxT, [&](int32_t proxy, float curMax)
+                {
+                    Collider2D* c = static_cast<Collider2D*>(tree.GetUserData(proxy));
+                    if (!AcceptQuery_(c, filter)) return curMax;
+
+                    maxT = callback(ShapeOf_(c), curMax);
+                    return maxT;
+                });
+        };
+
+    for (LayerBits used = mWorld.usedBuckets; used && maxT >= 0.f; used &= used - 1)
+    {
+        const int b = std::countr_zero(used);
+        if ((mWorld.bucketLayers[b] & filter.mask) == 0) continue;
+
+        visitTree(mWorld.trees[b]);
+        if (filter.hitTriggers && maxT >= 0.f) visitTree(mWorld.triggerTrees[b]);
+    }
+
+    for (LayerBits used = mWorld.usedStaticBuckets; used && maxT >= 0.f; used &= used - 1)
+    {
+        const int b = std::countr_zero(used);
+        if ((mWorld.staticBucketLayers[b] & filter.mask) == 0) continue;
+
+        mWorld.statics[b].RayCast(origin, dir, maxT, [&](uint32_t item, float curMax)
+            {
+                if (!AcceptQuery_(mWorld.staticCache.col[item], filter)) return curMax;
+
+                maxT = callback(StaticShapeOf_(item), curMax);
+                return maxT;
+            });
+    }
+}
+
+// Empate a la misma distancia: menor (ID, puntero), igual en cualquier orden de recorrido
+static inline bool CloserHit_(float t, const Collider2D* c, float bestT, const Collider2D* best, bool (*less)(const Collider2D*, const Collider2D*)) noexcept
+{
+    if (!best || t < bestT) return true;
+    return t == bestT && less(c, best);
+}
+
+bool CollisionManager::Cast_(const QueryShape_& s, const Vec2& dirIn, float maxDistance, RaycastHit2D& hit, const QueryFilter2D& filter) noexcept
+{
+    hit = RaycastHit2D{};
+    if (maxDistance < 0.f || math::LengthSq(dirIn) <= 1e-12f) return false;
+
+    PrepareQueries_();
+    const Vec2 dir = NormalizeSafe(dirIn);
+
+    float bestT = maxDistance;
+    Collider2D* best = nullptr;
+
+    auto consider = [&](const QueryShape_& target, float maxT)
+        {
+            float t; Vec2 n, p;
+            if (!CastShape_(s, dir, maxT, target, t, n, p)) return;
+            if (!CloserHit_(t, target.col, bestT, best, ColliderLess_)) return;
+
+            best = target.col;
+            bestT = t;
+            hit.collider = target.col;
+            hit.gameObject = target.col->mGameObject;
+            hit.point = p;
+            hit.normal = n;
+            hit.distance = t;
+        };
+
+    if (s.circle && s.radius == 0.f)
+    {
+        // Rayo: recorrido de los arboles recortando con el mejor impacto
+        RayCastShapes_(s.center, dir, maxDistance, filter, [&](const QueryShape_& target, float maxT)
+            {
+                consider(target, maxT);
+                return best ? bestT : maxT;
+            });
+    }
+    else
+    {
+        // Forma: candidatos en el AABB barrido
+        Rect swept = s.aabb;
+        swept.ExpandToInclude({ s.aabb.x + dir.x * maxDistance, s.aabb.y + dir.y * maxDistance });
+        swept.ExpandToInclude({ s.aabb.Right() + dir.x * maxDistance, s.aabb.Bottom() + dir.y * maxDistance });
+
+        QueryShapes_(swept, filter, [&](const QueryShape_& target)
+            {
+                consider(target, best ? bestT : maxDistance);
+                return true;
+            });
+    }
+
+    return best != nullptr;
+}
+
+bool CollisionManager::SweepCollider_(Collider2D* col, const RigidBody2D* body, const Vec2& delta, float& toi, Vec2& normal) noexcept
+{
+    const float dist = math::Length(delta);
+    if (!col || dist <= 1e-6f) return false;
+
+    PrepareQueries_();
+    const Vec2 dir = delta * (1.f / dist);
+
+    // Forma al principio del movimiento
+    QueryShape_ s = ShapeOf_(col);
+    s.center = s.center - delta;
+    s.aabb.x -= delta.x;
+    s.aabb.y -= delta.y;
+
+    Rect swept = s.aabb;
+    swept.ExpandToInclude({ s.aabb.x + delta.x, s.aabb.y + delta.y });
+    swept.ExpandToInclude({ s.aabb.Right() + delta.x, s.aabb.Bottom() + delta.y });
+
+    QueryFilter2D filter;
+    filter.mask = LayerRow_(col->layer_) & col->mask_;
+    filter.hitTriggers = false;
+
+    float bestT = dist;
+    Collider2D* best = nullptr;
+
+    QueryShapes_(swept, filter, [&](const QueryShape_& target)
+        {
+            Collider2D* tc = target.col;
+            if (tc == col || tc->isTrigger_) return true;
+            if ((LayerRow_(tc->layer_) & tc->mask_ & col->layer_) == 0) return true;
+            if (body && tc->GetAttachedBody() == body) return true;
+
+            // t = 0: ya se tocaban, eso lo resuelve el contacto normal
+            float t; Vec2 n, p;
+            if (!CastShape_(s, dir, best ? bestT : dist, target, t, n, p) || t <= 0.f) return true;
+            if (!CloserHit_(t, tc, bestT, best, ColliderLess_)) return true;
+
+            best = tc;
+            bestT = t;
+            normal = n;
+            return true;
+        });
+
+    if (!best) return false;
+    toi = bestT;
+    return true;
+}
+
+bool CollisionManager::Raycast(const Vec2& origin, const Vec2& dir, float maxDistance, RaycastHit2D& hit, const QueryFilter2D& filter) noexcept
+{
+    QueryShape_ ray;
+    ray.circle = true;
+    ray.center = origin;
+    ray.radius = 0.f;
+    return Cast_(ray, dir, maxDistance, hit, filter);
+}
+
+int CollisionManager::RaycastAll(const Vec2& origin, const Vec2& dirIn, float maxDistance, RaycastHit2D* hits, int maxHits, const QueryFilter2D& filter) noexcept
+{
+    if (!hits || maxHits <= 0 || maxDistance < 0.f || math::LengthSq(dirIn) <= 1e-12f) return 0;
+
+    PrepareQueries_();
+    const Vec2 dir = NormalizeSafe(dirIn);
+
+    QueryShape_ ray;
+    ray.circle = true;
+    ray.center = origin;
+
+    // Insercion ordenada en el buffer; lleno => solo entra lo que este mas cerca
+    int count = 0;
+    RayCastShapes_(origin, dir, maxDistance, filter, [&](const QueryShape_& target, float maxT)
+        {
+            float t; Vec2 n, p;
+            if (!CastShape_(ray, dir, maxT, target, t, n, p)) return maxT;
+
+            int pos = count;
+            while (pos > 0 && CloserHit_(t, target.col, hits[pos - 1].distance, hits[pos - 1].collider, ColliderLess_)) --pos;
+            if (pos >= maxHits) return maxT;
+
+            const int last = std::min(count, maxHits - 1);
+            for (int k = last; k > pos; --k) hits[k] = hits[k - 1];
+            if (count < maxHits) ++count;
+
+            RaycastHit2D& h = hits[pos];
+            h.collider = target.col;
+            h.gameObject = target.col->mGameObject;
+            h.point = p;
+            h.normal = n;
+            h.distance = t;
+
+            // Buffer lleno: lo que quede por detras del ultimo no puede entrar
+            return (count == maxHits) ? hits[count - 1].distance : maxT;
+        });
+
+    return count;
+}
+
+bool CollisionManager::CircleCast(const Vec2& origin, float radius, const Vec2& dir, float maxDistance, RaycastHit2D& hit, const QueryFilter2D& filter) noexcept
+{
+    QueryShape_ s;
+    s.circle = true;
+    s.center = origin;
+    s.radius = std::fabs(radius);
+    s.aabb = { origin.x - s.radius, origin.y - s.radius, s.radius * 2.f, s.radius * 2.f };
+    return Cast_(s, dir, maxDistance, hit, filter);
+}
+
+bool CollisionManager::BoxCast(const Vec2& origin, const Vec2& size, float angleDeg, const Vec2& dir, float maxDistance, RaycastHit2D& hit, const QueryFilter2D& filter) noexcept
+{
+    return Cast_(MakeQueryBox_(origin, size, angleDeg), dir, maxDistance, hit, filter);
+}
+
+int CollisionManager::OverlapPoint(const Vec2& point, Collider2D** results, int maxResults, const QueryFilter2D& filter) noexcept
+{
+    return OverlapCircle(point, 0.f, results, maxResults, filter);
+}
+
+int CollisionManager::OverlapCircle(const Vec2& center, float radius, Collider2D** results, int maxResults, const QueryFilter2D& filter) noexcept
+{
+    if (!results || maxResults <= 0) return 0;
+    PrepareQueries_();
+
+    const float r = std::fabs(radius);
+    const Rect aabb = { center.x - r, center.y - r, r * 2.f, r * 2.f };
+
+    int count = 0;
+    QueryShapes_(aabb, filter, [&](const QueryShape_& s)
+        {
+            const bool hit = s.circle
+                ? TestCircle_Circle(s.center, s.radius, center, r)
+                : TestOBB_Circle(s.center, s.half, s.rot, center, r);
+            if (hit) results[count++] = s.col;
+            return count < maxResults;
+        });
+    return count;
+}
+
+int CollisionManager::OverlapBox(const Vec2& center, const Vec2& size, float angleDeg, Collider2D** results, int maxResults, const QueryFilter2D& filter) noexcept
+{
+    if (!results || maxResults <= 0) return 0;
+    PrepareQueries_();
+
+    const QueryShape_ box = MakeQueryBox_(center, size, angleDeg);
+
+    int count = 0;
+    QueryShapes_(box.aabb, filter, [&](const QueryShape_& s)
+        {
+            const bool hit = s.circle
+                ? TestOBB_Circle(box.center, box.half, box.rot, s.center, s.radius)
+                : TestOBB_OBB(box.center, box.half, box.rot, s.center, s.half, s.rot);
+            if (hit) results[count++] = s.col;
+            return count < maxResults;
+        });
+    return count;
+}
+
+void CollisionManager::SyncTransforms() noexcept
+{
+    PrepareQueries_();
+    for (const DynamicRef& d : mWorld.dynamics)
+        TreeOf_(d.trigger, d.bucket).MoveProxy(d.proxy, d.col->WorldAABB());
+}
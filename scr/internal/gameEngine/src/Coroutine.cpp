@@ -0,0 +1,366 @@
+#include "Coroutine.h"
+
+#include <cmath>
+
+#include "Behaviour.h"
+#include "GameObject.h"
+
+// =========================
+// Awaitables
+// =========================
+void WaitForSeconds::await_suspend(std::coroutine_handle<Coroutine::promise_type> h) const noexcept
+{
+    auto& p = h.promise();
+    p.scheduler->WaitTicks(&p, seconds);
+}
+
+void WaitForFixedUpdate::await_suspend(std::coroutine_handle<Coroutine::promise_type> h) const noexcept
+{
+    auto& p = h.promise();
+    p.scheduler->WaitFixed(&p);
+}
+
+void WaitUntil::await_suspend(std::coroutine_handle<Coroutine::promise_type> h) noexcept
+{
+    auto& p = h.promise();
+    p.predicate = std::move(pred);
+    p.scheduler->WaitPredicate(&p);
+}
+
+// =========================
+// Listas intrusivas
+// =========================
+void CoroutineScheduler::PushBack_(CoroutineList& l, CoroutineNode* n) noexcept
+{
+    n->list = &l;
+    n->next = nullptr;
+    n->prev = l.tail;
+
+    if (l.tail) l.tail->next = n;
+    else l.head = n;
+    l.tail = n;
+}
+
+void CoroutineScheduler::Unlink_(CoroutineNode* n) noexcept
+{
+    CoroutineList* l = n->list;
+    if (!l) return;
+
+    if (n->prev) n->prev->next = n->next;
+    else l->head = n->next;
+
+    if (n->next) n->next->prev = n->prev;
+    else l->tail = n->prev;
+
+    n->prev = n->next = nullptr;
+    n->list = nullptr;
+}
+
+void CoroutineScheduler::MoveAll_(CoroutineList& from, CoroutineList& to) noexcept
+{
+    if (from.Empty()) return;
+
+    for (CoroutineNode* n = from.head; n; n = n->next)
+        n->list = &to;
+
+    if (to.tail)
+    {
+        to.tail->next = from.head;
+        from.head->prev = to.tail;
+    }
+    else
+    {
+        to.head = from.head;
+    }
+    to.tail = from.tail;
+
+    from.head = from.tail = nullptr;
+}
+
+// =========================
+// Ciclo de vida
+// =========================
+CoroutineScheduler::~CoroutineScheduler() noexcept
+{
+    // Normalmente vacio: OnDestroy de cada Behaviour ya paro las suyas
+    auto destroyAll = [](CoroutineList& l)
+    {
+        while (CoroutineNode* n = l.head)
+        {
+            Unlink_(n);
+            n->handle.destroy();
+        }
+    };
+
+    for (auto& level : mWheel)
+        for (auto& slot : level)
+            destroyAll(slot);
+
+    destroyAll(mDue);
+    destroyAll(mFixed);
+    destroyAll(mPolled);
+    destroyAll(mRunning);
+    destroyAll(mHeld);
+    destroyAll(mDeferred);
+}
+
+void CoroutineScheduler::Start(CoroutineNode* n) noexcept
+{
+    Behaviour* owner = n->owner;
+    n->scheduler = this;
+
+    n->ownerPrev = nullptr;
+    n->ownerNext = owner->mCoroutines;
+    if (owner->mCoroutines) owner->mCoroutines->ownerPrev = n;
+    owner->mCoroutines = n;
+
+    ++mCount;
+
+    // Corre hasta su primer co_await
+    Resume_(n);
+}
+
+void CoroutineScheduler::StopAll(Behaviour* owner) noexcept
+{
+    CoroutineNode* n = owner->mCoroutines;
+    while (n)
+    {
+        CoroutineNode* next = n->ownerNext;
+
+        if (n->running)
+        {
+            // Se esta parando a si misma: se libera al volver de resume()
+            n->cancelled = true;
+            n->owner = nullptr;
+            n->ownerPrev = n->ownerNext = nullptr;
+        }
+        else
+        {
+            Release_(n);
+        }
+
+        n = next;
+    }
+
+    owner->mCoroutines = nullptr;
+}
+
+void CoroutineScheduler::ResumeHeld(Behaviour* owner) noexcept
+{
+    // Vuelven a la cola de la que salieron: se reanudan en el siguiente Update / paso fijo
+    for (CoroutineNode* n = owner->mCoroutines; n; n = n->ownerNext)
+    {
+        if (n->list != &mHeld) continue;
+        Unlink_(n);
+        PushBack_(*n->heldFrom, n);
+    }
+}
+
+bool CoroutineScheduler::Hold_(CoroutineNode* n, CoroutineList& back, CoroutineList& retry, bool fixed) noexcept
+{
+    const GameObject* go = n->owner ? n->owner->mGameObject : nullptr;
+    if (!go) return false;
+
+    if (go->mStreamedOut || go->mLodTier == SimulationLod::Frozen)
+    {
+        n->heldFrom = &back;
+        PushBack_(mHeld, n);
+        return true;
+    }
+
+    // Reduced: la espera se alarga hasta su siguiente tick (Update o FixedUpdate)
+    if (go->mLodTier == SimulationLod::Reduced && !(fixed ? go->mLodScale > 0.f : go->mLodFrameTick))
+    {
+        PushBack_(retry, n);
+        return true;
+    }
+
+    return false;
+}
+
+void CoroutineScheduler::Resume_(CoroutineNode* n) noexcept
+{
+    n->running = true;
+    n->handle.resume();
+    n->running = false;
+
+    if (n->handle.done() || n->cancelled)
+        Release_(n);
+}
+
+void CoroutineScheduler::Release_(CoroutineNode* n) noexcept
+{
+    if (n->list)
+    {
+        const CoroutineList* first = &mWheel[0][0];
+        if (n->list >= first && n->list < first + kLevels * kSlots) --mTimers;
+        Unlink_(n);
+    }
+
+    if (n->owner)
+    {
+        if (n->ownerPrev) n->ownerPrev->ownerNext = n->ownerNext;
+        else n->owner->mCoroutines = n->ownerNext;
+
+        if (n->ownerNext) n->ownerNext->ownerPrev = n->ownerPrev;
+    }
+
+    --mCount;
+    n->handle.destroy();    // el nodo vive en el promise: n deja de ser valido
+}
+
+// =========================
+// Esperas
+// =========================
+void CoroutineScheduler::WaitTicks(CoroutineNode* n, float seconds) noexcept
+{
+    const double ms = (seconds > 0.f) ? (double)seconds * 1000.0 : 0.0;
+    n->expireTick = (uint64_t)std::llround(mTimeMs + ms);   // resolucion de 1 ms
+
+    InsertTimer_(n);
+    ++mTimers;
+}
+
+void CoroutineScheduler::WaitFixed(CoroutineNode* n) noexcept
+{
+    PushBack_(mFixed, n);
+}
+
+void CoroutineScheduler::WaitPredicate(CoroutineNode* n) noexcept
+{
+    PushBack_(mPolled, n);
+}
+
+// =========================
+// Rueda de timers
+// =========================
+void CoroutineScheduler::InsertTimer_(CoroutineNode* n) noexcept
+{
+    uint64_t expire = (n->expireTick < mBase) ? mBase : n->expireTick;
+    uint64_t delta = expire - mBase;
+
+    // Fuera de rango: se cuelga en el ultimo slot posible y se recoloca al cascadear
+    if (delta > kMaxDelta)
+    {
+        delta = kMaxDelta;
+        expire = mBase + kMaxDelta;
+    }
+
+    int level = 0;
+    while (level < kLevels - 1 && delta >= (1ull << (kSlotBits * (level + 1))))
+        ++level;
+
+    const uint64_t index = (expire >> (kSlotBits * level)) & kSlotMask;
+    PushBack_(mWheel[level][index], n);
+}
+
+void CoroutineScheduler::Cascade_(int level, uint64_t index) noexcept
+{
+    CoroutineList& slot = mWheel[level][index];
+    CoroutineNode* n = slot.head;
+    slot.head = slot.tail = nullptr;
+
+    while (n)
+    {
+        CoroutineNode* next = n->next;
+        n->prev = n->next = nullptr;
+        n->list = nullptr;
+        InsertTimer_(n);
+        n = next;
+    }
+}
+
+void CoroutineScheduler::Advance_(uint64_t target) noexcept
+{
+    while (mBase <= target)
+    {
+        // Rueda vacia: saltar directamente
+        if (mTimers == 0)
+        {
+            mBase = target + 1;
+            return;
+        }
+
+        const uint64_t index = mBase & kSlotMask;
+
+        // Al dar la vuelta el nivel 0, bajar el slot que toca de los niveles superiores
+        if (index == 0)
+        {
+            for (int level = 1; level < kLevels; ++level)
+            {
+                const uint64_t li = (mBase >> (kSlotBits * level)) & kSlotMask;
+                Cascade_(level, li);
+                if (li != 0) break;
+            }
+        }
+
+        CoroutineList& slot = mWheel[0][index];
+        for (CoroutineNode* n = slot.head; n; n = n->next)
+            --mTimers;
+        MoveAll_(slot, mDue);
+
+        ++mBase;
+    }
+}
+
+// =========================
+// Bucle
+// =========================
+void CoroutineScheduler::Update(float dt) noexcept
+{
+    if (mCount == 0) return;
+
+    if (dt > 0.f) mTimeMs += (double)dt * 1000.0;
+    Advance_((uint64_t)std::llround(mTimeMs));
+
+    // Timers vencidos (un resume solo puede volver a la rueda, nunca a mDue),
+    // primero los que esperaban al tick de su dueno
+    MoveAll_(mDue, mDeferred);
+    MoveAll_(mDeferred, mDue);
+    while (CoroutineNode* n = mDue.head)
+    {
+        Unlink_(n);
+        if (!Hold_(n, mDue, mDeferred, false)) Resume_(n);
+    }
+
+    // WaitUntil: se evalua una vez por frame
+    MoveAll_(mPolled, mRunning);
+    while (CoroutineNode* n = mRunning.head)
+    {
+        Unlink_(n);
+
+        // Con el dueno suspendido ni se evalua el predicado
+        if (Hold_(n, mPolled, mPolled, false)) continue;
+
+        n->running = true;
+        const bool ready = !n->predicate || n->predicate();
+        n->running = false;
+
+        if (n->cancelled)
+        {
+            Release_(n);
+        }
+        else if (ready)
+        {
+            n->predicate = nullptr;
+            Resume_(n);
+        }
+        else
+        {
+            PushBack_(mPolled, n);
+        }
+    }
+}
+
+void CoroutineScheduler::FixedUpdate() noexcept
+{
+    if (mFixed.Empty()) return;
+
+    // Lote cerrado: si vuelven a esperar WaitForFixedUpdate van al siguiente paso
+    MoveAll_(mFixed, mRunning);
+    while (CoroutineNode* n = mRunning.head)
+    {
+        Unlink_(n);
+        if (!Hold_(n, mFixed, mFixed, true)) Resume_(n);
+    }
+}
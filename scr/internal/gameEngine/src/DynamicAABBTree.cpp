@@ -0,0 +1,327 @@
+#include "DynamicAABBTree.h"
+
+#include <algorithm>
+
+// =================== Utilidades de AABB ===================
+static inline Rect Combine(const Rect& a, const Rect& b) noexcept
+{
+    const float l = std::min(a.Left(), b.Left());
+    const float t = std::min(a.Top(), b.Top());
+    const float r = std::max(a.Right(), b.Right());
+    const float btm = std::max(a.Bottom(), b.Bottom());
+    return { l, t, r - l, btm - t };
+}
+
+static inline float Perimeter(const Rect& r) noexcept
+{
+    return 2.f * (r.w + r.h);
+}
+
+static inline bool ContainsRect(const Rect& outer, const Rect& inner) noexcept
+{
+    return inner.Left() >= outer.Left() && inner.Right() <= outer.Right() &&
+        inner.Top() >= outer.Top() && inner.Bottom() <= outer.Bottom();
+}
+
+static inline Rect Fatten(const Rect& r) noexcept
+{
+    const float m = DynamicAABBTree::kMargin;
+    return { r.x - m, r.y - m, r.w + 2.f * m, r.h + 2.f * m };
+}
+
+// =================== Pool de nodos ===================
+int32_t DynamicAABBTree::AllocateNode_() noexcept
+{
+    if (mFreeList == kNull)
+    {
+        mNodes.emplace_back();
+        return (int32_t)mNodes.size() - 1;
+    }
+
+    const int32_t id = mFreeList;
+    mFreeList = mNodes[id].parent;
+    mNodes[id] = Node{};
+    return id;
+}
+
+void DynamicAABBTree::FreeNode_(int32_t id) noexcept
+{
+    Node& n = mNodes[id];
+    n.userData = nullptr;
+    n.child1 = n.child2 = kNull;
+    n.height = -1;
+    n.parent = mFreeList;
+    mFreeList = id;
+}
+
+void DynamicAABBTree::Clear() noexcept
+{
+    mNodes.clear();
+    mRoot = kNull;
+    mFreeList = kNull;
+    mProxyCount = 0;
+}
+
+// =================== Proxies ===================
+int32_t DynamicAABBTree::CreateProxy(const Rect& aabb, void* userData) noexcept
+{
+    const int32_t id = AllocateNode_();
+    Node& n = mNodes[id];
+    n.aabb = Fatten(aabb);
+    n.userData = userData;
+    n.height = 0;
+
+    InsertLeaf_(id);
+    ++mProxyCount;
+    return id;
+}
+
+void DynamicAABBTree::DestroyProxy(int32_t proxy) noexcept
+{
+    if (proxy < 0 || proxy >= (int32_t)mNodes.size() || !mNodes[proxy].IsLeaf()) return;
+
+    RemoveLeaf_(proxy);
+    FreeNode_(proxy);
+    --mProxyCount;
+}
+
+bool DynamicAABBTree::MoveProxy(int32_t proxy, const Rect& aabb) noexcept
+{
+    // Sigue dentro del AABB engordado: nada que hacer
+    if (ContainsRect(mNodes[proxy].aabb, aabb)) return false;
+
+    RemoveLeaf_(proxy);
+    mNodes[proxy].aabb = Fatten(aabb);
+    InsertLeaf_(proxy);
+    return true;
+}
+
+// =================== Insercion / borrado ===================
+void DynamicAABBTree::InsertLeaf_(int32_t leaf) noexcept
+{
+    if (mRoot == kNull)
+    {
+        mRoot = leaf;
+        mNodes[leaf].parent = kNull;
+        return;
+    }
+
+    // 1) Buscar el mejor hermano bajando por el menor coste de perimetro
+    const Rect leafAABB = mNodes[leaf].aabb;
+    int32_t index = mRoot;
+
+    while (!mNodes[index].IsLeaf())
+    {
+        const Node& node = mNodes[index];
+        const int32_t c1 = node.child1;
+        const int32_t c2 = node.child2;
+
+        const float area = Perimeter(node.aabb);
+        const float combinedArea = Perimeter(Combine(node.aabb, leafAABB));
+
+        // Coste de crear un padre nuevo aqui
+        const float cost = 2.f * combinedArea;
+
+        // Coste minimo de bajar (lo que crece este nodo)
+        const float inheritance = 2.f * (combinedArea - area);
+
+        auto descendCost = [&](int32_t c) noexcept {
+            const Rect merged = Combine(leafAABB, mNodes[c].aabb);
+            if (mNodes[c].IsLeaf()) return Perimeter(merged) + inheritance;
+            return (Perimeter(merged) - Perimeter(mNodes[c].aabb)) + inheritance;
+            };
+
+        const float cost1 = descendCost(c1);
+        const float cost2 = descendCost(c2);
+
+        if (cost < cost1 && cost < cost2) break;
+
+        index = (cost1 < cost2) ? c1 : c2;
+    }
+
+    // 2) Nuevo padre para (hermano, hoja)
+    const int32_t sibling = index;
+    const int32_t oldParent = mNodes[sibling].parent;
+    const int32_t newParent = AllocateNode_();     // puede realojar mNodes: solo indices
+
+    mNodes[newParent].parent = oldParent;
+    mNodes[newParent].aabb = Combine(leafAABB, mNodes[sibling].aabb);
+    mNodes[newParent].height = mNodes[sibling].height + 1;
+    mNodes[newParent].child1 = sibling;
+    mNodes[newParent].child2 = leaf;
+    mNodes[sibling].parent = newParent;
+    mNodes[leaf].parent = newParent;
+
+    if (oldParent != kNull)
+    {
+        if (mNodes[oldParent].child1 == sibling) mNodes[oldParent].child1 = newParent;
+        else mNodes[oldParent].child2 = newParent;
+    }
+    else
+    {
+        mRoot = newParent;
+    }
+
+    // 3) Subir reajustando alturas y AABBs
+    index = mNodes[leaf].parent;
+    while (index != kNull)
+    {
+        index = Balance_(index);
+
+        Node& n = mNodes[index];
+        n.height = 1 + std::max(mNodes[n.child1].height, mNodes[n.child2].height);
+        n.aabb = Combine(mNodes[n.child1].aabb, mNodes[n.child2].aabb);
+
+        index = n.parent;
+    }
+}
+
+void DynamicAABBTree::RemoveLeaf_(int32_t leaf) noexcept
+{
+    if (leaf == mRoot)
+    {
+        mRoot = kNull;
+        return;
+    }
+
+    const int32_t parent = mNodes[leaf].parent;
+    const int32_t grandParent = mNodes[parent].parent;
+    const int32_t sibling = (mNodes[parent].child1 == leaf) ? mNodes[parent].child2 : mNodes[parent].child1;
+
+    if (grandParent != kNull)
+    {
+        // El hermano ocupa el sitio del padre
+        if (mNodes[grandParent].child1 == parent) mNodes[grandParent].child1 = sibling;
+        else mNodes[grandParent].child2 = sibling;
+        mNodes[sibling].parent = grandParent;
+        FreeNode_(parent);
+
+        int32_t index = grandParent;
+        while (index != kNull)
+        {
+            index = Balance_(index);
+
+            Node& n = mNodes[index];
+            n.height = 1 + std::max(mNodes[n.child1].height, mNodes[n.child2].height);
+            n.aabb = Combine(mNodes[n.child1].aabb, mNodes[n.child2].aabb);
+
+            index = n.parent;
+        }
+    }
+    else
+    {
+        mRoot = sibling;
+        mNodes[sibling].parent = kNull;
+        FreeNode_(parent);
+    }
+
+    mNodes[leaf].parent = kNull;
+}
+
+// Rotacion si un hijo es mas de 1 nivel mas alto que el otro. Devuelve la nueva raiz del subarbol.
+int32_t DynamicAABBTree::Balance_(int32_t iA) noexcept
+{
+    Node& A = mNodes[iA];
+    if (A.IsLeaf() || A.height < 2) return iA;
+
+    const int32_t iB = A.child1;
+    const int32_t iC = A.child2;
+    Node& B = mNodes[iB];
+    Node& C = mNodes[iC];
+
+    const int32_t balance = C.height - B.height;
+
+    // Subir C
+    if (balance > 1)
+    {
+        const int32_t iF = C.child1;
+        const int32_t iG = C.child2;
+        Node& F = mNodes[iF];
+        Node& G = mNodes[iG];
+
+        C.child1 = iA;
+        C.parent = A.parent;
+        A.parent = iC;
+
+        if (C.parent != kNull)
+        {
+            if (mNodes[C.parent].child1 == iA) mNodes[C.parent].child1 = iC;
+            else mNodes[C.parent].child2 = iC;
+        }
+        else
+        {
+            mRoot = iC;
+        }
+
+        if (F.height > G.height)
+        {
+            C.child2 = iF;
+            A.child2 = iG;
+            G.parent = iA;
+            A.aabb = Combine(B.aabb, G.aabb);
+            C.aabb = Combine(A.aabb, F.aabb);
+            A.height = 1 + std::max(B.height, G.height);
+            C.height = 1 + std::max(A.height, F.height);
+        }
+        else
+        {
+            C.child2 = iG;
+            A.child2 = iF;
+            F.parent = iA;
+            A.aabb = Combine(B.aabb, F.aabb);
+            C.aabb = Combine(A.aabb, G.aabb);
+            A.height = 1 + std::max(B.height, F.height);
+            C.height = 1 + std::max(A.height, G.height);
+        }
+
+        return iC;
+    }
+
+    // Subir B
+    if (balance < -1)
+    {
+        const int32_t iD = B.child1;
+        const int32_t iE = B.child2;
+        Node& D = mNodes[iD];
+        Node& E = mNodes[iE];
+
+        B.child1 = iA;
+        B.parent = A.parent;
+        A.parent = iB;
+
+        if (B.parent != kNull)
+        {
+            if (mNodes[B.parent].child1 == iA) mNodes[B.parent].child1 = iB;
+            else mNodes[B.parent].child2 = iB;
+        }
+        else
+        {
+            mRoot = iB;
+        }
+
+        if (D.height > E.height)
+        {
+            B.child2 = iD;
+            A.child1 = iE;
+            E.parent = iA;
+            A.aabb = Combine(C.aabb, E.aabb);
+            B.aabb = Combine(A.aabb, D.aabb);
+            A.height = 1 + std::max(C.height, E.height);
+            B.height = 1 + std::max(A.height, D.height);
+        }
+        else
+        {
+            B.child2 = iE;
+            A.child1 = iD;
+            D.parent = iA;
+            A.aabb = Combine(C.aabb, D.aabb);
+            B.aabb = Combine(A.aabb, E.aabb);
+            A.height = 1 + std::max(C.height, D.height);
+            B.height = 1 + std::max(A.height, E.height);
+        }
+
+        return iB;
+    }
+
+    return iA;
+}
@@ -4,6 +4,7 @@
 #include <nlohmann/json.hpp>
 
 #include <sstream>
+#include <algorithm>
 #include <cstdlib> // Para system()
 #include <inttypes.h> // Para uint64_t
 
@@ -58,6 +59,7 @@
 #include "SceneManager.h"
 #include "PhysicsManager.h"
 #include "RandomManager.h"
+#include "JobSystem.h"
 
 // Scene
 #include "Camera2D.h"
@@ -76,6 +78,7 @@ Engine::Engine() noexcept
 	if (success) success = AssetManager::CreateSingleton();
 	if (success) success = SoundManager::CreateSingleton();
 	if (success) success = RenderManager::CreateSingleton();
+	if (success) success = JobSystem::CreateSingleton();
 	if (success) success = CollisionManager::CreateSingleton();
     if (success) success = PhysicsManager::CreateSingleton();
 	if (success) success = UIManager::CreateSingleton();
@@ -98,6 +101,8 @@ Engine::Engine() noexcept
 		else stopDestroying = true;
 		if (!stopDestroying && RenderManager::GetInstancePtr() != nullptr) RenderManager::DestroySingleton();
 		else stopDestroying = true;
+		if (!stopDestroying && JobSystem::GetInstancePtr() != nullptr) JobSystem::DestroySingleton();
+		else stopDestroying = true;
 		if (!stopDestroying && CollisionManager::GetInstancePtr() != nullptr) CollisionManager::DestroySingleton();
         else stopDestroying = true;
         if (!stopDestroying && PhysicsManager::GetInstancePtr() != nullptr) PhysicsManager::DestroySingleton();
@@ -121,6 +126,7 @@ Engine::~Engine()
     if (UIManager::GetInstancePtr())        UIManager::DestroySingleton();
     if (PhysicsManager::GetInstancePtr())   PhysicsManager::DestroySingleton();
     if (CollisionManager::GetInstancePtr()) CollisionManager::DestroySingleton();
+    if (JobSystem::GetInstancePtr())        JobSystem::DestroySingleton();
     if (RenderManager::GetInstancePtr())    RenderManager::DestroySingleton();
     if (SoundManager::GetInstancePtr())     SoundManager::DestroySingleton();
     if (AssetManager::GetInstancePtr())     AssetManager::DestroySingleton();
@@ -192,13 +198,14 @@ bool Engine::StartImpl(const std::string configPath) noexcept
     auto* assets = AssetManager::GetInstancePtr();
     auto* sound = SoundManager::GetInstancePtr();
     auto* render = RenderManager::GetInstancePtr();
+    auto* jobs = JobSystem::GetInstancePtr();
     auto* collision = CollisionManager::GetInstancePtr();
     auto* physics = PhysicsManager::GetInstancePtr();
     auto* ui = UIManager::GetInstancePtr();
     auto* scenes = SceneManager::GetInstancePtr();
 
     if (!win || !time || !random || !input || !assets || !sound ||
-        !render || !collision || !physics || !ui || !scenes)
+        !render || !jobs || !collision || !physics || !ui || !scenes)
     {
         LogError("Engine error", "Start(): One or more managers are null, check Engine::Engine()");
         return false;
@@ -304,8 +311,28 @@ bool Engine::StartImpl(const std::string configPath) noexcept
     }
     printf("OK\n");
 
+    printf("Initializing JobSystem... ");
+    {
+        JobSystem::Config cfg{ mCfg.workerThreads };
+
+        ok = jobs->Init(cfg);
+        if (!ok)
+        {
+            LogError("Engine Start", "JobSystem::Init() failed.");
+            return false;
+        }
+    }
+    printf("OK (%u threads)\n", jobs->GetThreadCount());
+
     printf("Initializing CollisionManager... ");
-    ok = collision->Init();
+    {
+        CollisionManager::Config cfg
+        {
+            mCfg.collision.ignoreLayerPairs,
+        };
+
+        ok = collision->Init(cfg);
+    }
     if (!ok)
     {
         LogError("Engine Start", "CollisionManager::Init() failed.");
@@ -322,6 +349,13 @@ bool Engine::StartImpl(const std::string configPath) noexcept
             mCfg.physics.penetrationPercent,
             mCfg.physics.maxSubsteps,
             mCfg.physics.ccdMinSizeFactor,
+            mCfg.physics.ccdSubstepping,
+            mCfg.physics.velocityIterations,
+            mCfg.physics.solverTolerance,
+            mCfg.physics.enableSleeping,
+            mCfg.physics.sleepLinearVelocity,
+            mCfg.physics.sleepAngularVelocity,
+            mCfg.physics.timeToSleep,
         };
 
         ok = physics->Init(cfg);
@@ -355,11 +389,19 @@ bool Engine::StartImpl(const std::string configPath) noexcept
     printf("OK\n");
 
     printf("Initializing SceneManager... ");
-    ok = scenes->Init();
-    if (!ok)
     {
-        LogError("Engine Start", "SceneManager::Init() failed.");
-        return false;
+        SceneManager::Config cfg
+        {
+            mCfg.scenes.activationBudgetMs,
+            mCfg.scenes.activationBudgetCount,
+        };
+
+        ok = scenes->Init(cfg);
+        if (!ok)
+        {
+            LogError("Engine Start", "SceneManager::Init() failed.");
+            return false;
+        }
     }
     printf("OK\n");
 
@@ -455,6 +497,7 @@ void Engine::StopImpl() noexcept
     auto* assets = AssetManager::GetInstancePtr();
     auto* sound = SoundManager::GetInstancePtr();
     auto* render = RenderManager::GetInstancePtr();
+    auto* jobs = JobSystem::GetInstancePtr();
     auto* collision = CollisionManager::GetInstancePtr();
     auto* physics = PhysicsManager::GetInstancePtr();
     auto* ui = UIManager::GetInstancePtr();
@@ -476,6 +519,10 @@ void Engine::StopImpl() noexcept
     if (collision) { collision->Shutdown(); }
     printf("OK\n");
 
+    printf("Shutting down JobSystem... ");
+    if (jobs) { jobs->Shutdown(); }
+    printf("OK\n");
+
     printf("Shutting down SoundManager... ");
     if (sound) { sound->Shutdown(); }
     printf("OK\n");
@@ -677,7 +724,18 @@ static inline Color ParseColor(const std::string& s)
     "penetrationSlop": 0.01,
     "penetrationPercent": 0.8,
     "maxSubsteps":     8,
-    "ccdMinSizeFactor":0.5
+    "ccdMinSizeFactor":0.5,
+    "ccdSubstepping": false,
+    "velocityIterations": 4,
+    "solverTolerance": 0.001,
+    "enableSleeping": true,
+    "sleepLinearVelocity": 0.05,
+    "sleepAngularVelocity": 0.05,
+    "timeToSleep": 0.5
+  },
+  "Scenes": {
+    "activationBudgetMs":    0.0,
+    "activationBudgetCount": 0
   }
 }
 
@@ -768,6 +826,8 @@ bool Engine::LoadConfigFromFile(const std::string& path, Config& out) noexcept
                 out.logStats = eng["logStats"].get<bool>();
             if (eng.contains("logErrors") && eng["logErrors"].is_boolean())
                 out.logErrors = eng["logErrors"].get<bool>();
+            if (eng.contains("workerThreads") && eng["workerThreads"].is_number_integer())
+                out.workerThreads = eng["workerThreads"].get<int>();
         }
 
         // ===========================
@@ -911,6 +971,61 @@ bool Engine::LoadConfigFromFile(const std::string& path, Config& out) noexcept
 
             if (p.contains("ccdMinSizeFactor") && p["ccdMinSizeFactor"].is_number())
                 out.physics.ccdMinSizeFactor = p["ccdMinSizeFactor"].get<float>();
+
+            if (p.contains("ccdSubstepping") && p["ccdSubstepping"].is_boolean())
+                out.physics.ccdSubstepping = p["ccdSubstepping"].get<bool>();
+
+            if (p.contains("velocityIterations") && p["velocityIterations"].is_number_integer())
+                out.physics.velocityIterations = p["velocityIterations"].get<int>();
+
+            if (p.contains("solverTolerance") && p["solverTolerance"].is_number())
+                out.physics.solverTolerance = p["solverTolerance"].get<float>();
+
+            if (p.contains("enableSleeping") && p["enableSleeping"].is_boolean())
+                out.physics.enableSleeping = p["enableSleeping"].get<bool>();
+
+            if (p.contains("sleepLinearVelocity") && p["sleepLinearVelocity"].is_number())
+                out.physics.sleepLinearVelocity = p["sleepLinearVelocity"].get<float>();
+
+            if (p.contains("sleepAngularVelocity") && p["sleepAngularVelocity"].is_number())
+                out.physics.sleepAngularVelocity = p["sleepAngularVelocity"].get<float>();
+
+            if (p.contains("timeToSleep") && p["timeToSleep"].is_number())
+                out.physics.timeToSleep = p["timeToSleep"].get<float>();
+        }
+
+        // ===========================
+        //  Collision 
+        // ===========================
+        if (auto it = j.find("Collision"); it != j.end() && it->is_object())
+        {
+            const json& c = *it;
+
+            // ignoreLayerPairs: [[a,b], ...]
+            if (c.contains("ignoreLayerPairs") && c["ignoreLayerPairs"].is_array())
+            {
+                out.collision.ignoreLayerPairs.clear();
+                for (const json& pair : c["ignoreLayerPairs"])
+                {
+                    if (!pair.is_array() || pair.size() != 2) continue;
+                    if (!pair[0].is_number_integer() || !pair[1].is_number_integer()) continue;
+                    out.collision.ignoreLayerPairs.emplace_back(pair[0].get<int>(), pair[1].get<int>());
+                }
+            }
+        }
+
+        // ===========================
+        //  Scenes 
+        // ===========================
+        if (auto it = j.find("Scenes"); it != j.end() && it->is_object())
+        {
+            const json& s = *it;
+
+            if (s.contains("activationBudgetMs") && s["activationBudgetMs"].is_number())
+                out.scenes.activationBudgetMs = s["activationBudgetMs"].get<float>();
+
+            if (s.contains("activationBudgetCount") && s["activationBudgetCount"].is_number_integer())
+                out.scenes.activationBudgetCount = s["activationBudgetCount"].get<int>();
         }
     }
     catch (const json::parse_error& e)
@@ -1135,19 +1250,46 @@ void Engine::DrawStatsOverlay_() noexcept
         mStatsLines.push_back(SPrintf_("Game Objects In Scene:          %" PRIu64 " objects", (std::uint64_t)scenes->GetActive()->mEntities.size()));
         mStatsLines.push_back(SPrintf_("GOs Instantiated This Frame:    %" PRIu64 " objects", (std::uint64_t)scenes->GetActive()->mNew.size()));
         mStatsLines.push_back(SPrintf_("GOs Destroyed This Frame:       %" PRIu64 " objects", (std::uint64_t)scenes->GetActive()->mDestroyQueue.size()));
+        mStatsLines.push_back(SPrintf_("GOs Pending Activation:         %" PRIu64 " objects", (std::uint64_t)scenes->GetActive()->mUninitialized.size()));
+        mStatsLines.push_back(SPrintf_("Coroutines Alive:               %" PRIu64 "", (std::uint64_t)scenes->GetActive()->mCoroutines.GetCount()));
+        {
+            std::uint64_t activeChunks = 0;
+            for (auto& [key, chunk] : scenes->GetActive()->mChunks)
+                if (chunk.active) ++activeChunks;
+            mStatsLines.push_back(SPrintf_("World Chunks (active/total):    %" PRIu64 " / %" PRIu64 "", activeChunks, (std::uint64_t)scenes->GetActive()->mChunks.size()));
+        }
+        {
+            const uint32_t* lod = scenes->GetActive()->mLodCounts;
+            mStatsLines.push_back(SPrintf_("Sim LOD (full/reduced/frozen):  %u / %u / %u objects", (unsigned)lod[0], (unsigned)lod[1], (unsigned)lod[2]));
+        }
         mStatsLines.push_back("");
 
-        blockSizes.push_back(5);
+        blockSizes.push_back(9);
 
         mStatsLines.push_back("=== Collision Stats ===");
-        mStatsLines.push_back(SPrintf_("Registered Colliders:              %" PRIu64 " colliders", (std::uint64_t)collision->mRegisteredColliders.size()));
+        mStatsLines.push_back(SPrintf_("Registered Colliders:              %" PRIu64 " colliders", (std::uint64_t)collision->mWorld.colliders.size()));
+        std::uint64_t solidProxies = 0, triggerProxies = 0, staticNodes = 0;
+        int maxTreeHeight = 0, layerBuckets = 0;
+        for (int b = 0; b < CollisionManager::kLayerCount; ++b)
+        {
+            const auto& w = collision->mWorld;
+            solidProxies += (std::uint64_t)w.trees[b].GetProxyCount();
+            triggerProxies += (std::uint64_t)w.triggerTrees[b].GetProxyCount();
+            staticNodes += (std::uint64_t)w.statics[b].GetNodeCount();
+            maxTreeHeight = std::max({ maxTreeHeight, w.trees[b].GetHeight(), w.triggerTrees[b].GetHeight() });
+            if (((w.usedBuckets | w.usedStaticBuckets) >> b) & 1u) ++layerBuckets;
+        }
+        mStatsLines.push_back(SPrintf_("AABB Trees (proxies/max height):   %" PRIu64 "/%d (+%" PRIu64 " triggers, %d layers)", solidProxies, maxTreeHeight, triggerProxies, layerBuckets));
+        mStatsLines.push_back(SPrintf_("Static BVH (colliders/nodes):      %" PRIu64 "/%" PRIu64, (std::uint64_t)collision->mWorld.staticCache.Size(), staticNodes));
         mStatsLines.push_back(SPrintf_("Broadphase Checks (per frame):     %d checks", collision->nBroadphaseTestsThisFrame));
-        mStatsLines.push_back(SPrintf_("Narrowphase Checks (per frame):    %d checks", collision->nNarrowphaseTestsThisFrame));
+        mStatsLines.push_back(SPrintf_("Narrowphase Checks (per frame):    %d checks (%d culled in %s batches, %d jobs)", collision->nNarrowphaseTestsThisFrame, collision->nNarrowCulledThisFrame, narrow::HasSimd() ? "SSE2" : "scalar", collision->nNarrowJobsThisFrame));
+        mStatsLines.push_back(SPrintf_("Trigger Overlaps (per frame):      %d tests, %" PRIu64 " overlapping", collision->nTriggerTestsThisFrame, (std::uint64_t)collision->nTriggerOverlapsThisFrame));
+        mStatsLines.push_back(SPrintf_("Detection Passes (last step):      %d (dispatch reused %" PRIu64 " / fallback %" PRIu64 ")", collision->nDetectionPassesLastStep, collision->nDispatchReused, collision->nDispatchFallback));
         mStatsLines.push_back(SPrintf_("Contacts Built This Frame:         %" PRIu64 " contacts", (std::uint64_t)collision->nContactsBuiltThisFrame));
-        mStatsLines.push_back(SPrintf_("Active Pairs:                      %" PRIu64 " pairs", (std::uint64_t)collision->mCurrPairs.size()));
+        mStatsLines.push_back(SPrintf_("Active Pairs (table used/slots):   %" PRIu64 " pairs (%" PRIu64 "/%" PRIu64 "), %" PRIu64 " events", (std::uint64_t)collision->nActivePairs, (std::uint64_t)collision->mWorld.pairs.Size(), (std::uint64_t)collision->mWorld.pairs.Capacity(), (std::uint64_t)collision->nEventsThisFrame));
         mStatsLines.push_back("");
 
-        blockSizes.push_back(6);
+        blockSizes.push_back(10);
 
         mStatsLines.push_back("=== Assets Stats ===");
         mStatsLines.push_back(SPrintf_("Textures Loaded:                %" PRIu64 " textures", (std::uint64_t)assets->mTextures.size()));
@@ -1159,18 +1301,20 @@ void Engine::DrawStatsOverlay_() noexcept
 
         blockSizes.push_back(6);
 
-        std::uint64_t bodiesRegistered = (std::uint64_t)physics->mBodies.size();
+        std::uint64_t bodiesRegistered = (std::uint64_t)physics->mWorld.bodies.Size();
         std::uint64_t bodiesActive = 0;
         std::uint64_t bodiesDynamic = 0, bodiesKinematic = 0, bodiesStatic = 0;
         std::uint64_t bodiesCCD = 0;
         std::uint64_t bodiesWithConstraints = 0;
         std::uint64_t bodiesFreezeRot = 0, bodiesFreezePos = 0;
 
-        for (auto& [rb, active] : physics->mBodies)
+        const auto& bodies = physics->mWorld.bodies;
+        for (uint32_t i = 0; i < bodies.Size(); ++i)
         {
+            const RigidBody2D* rb = bodies.rb[i];
             if (!rb) continue;
 
-            if (active) bodiesActive++;
+            if (bodies.active[i]) bodiesActive++;
 
             switch (rb->bodyType)
             {
@@ -1194,15 +1338,18 @@ void Engine::DrawStatsOverlay_() noexcept
         mStatsLines.push_back(SPrintf_("Registered Bodies:                %" PRIu64 " bodies", bodiesRegistered));
         mStatsLines.push_back(SPrintf_("Active Bodies:                    %" PRIu64 " bodies", bodiesActive));
         mStatsLines.push_back(SPrintf_("Body Types:                       dyn %" PRIu64 " / kin %" PRIu64 " / static %" PRIu64, bodiesDynamic, bodiesKinematic, bodiesStatic));
+        mStatsLines.push_back(SPrintf_("Sleeping Bodies:                  %d bodies (%d islands)", physics->nSleepingBodies, physics->nIslands));
         mStatsLines.push_back(SPrintf_("CCD Enabled (Dynamic):            %" PRIu64 " bodies", bodiesCCD));
         mStatsLines.push_back(SPrintf_("Gravity:                          [%.3f, %.3f] m/s^2", (double)physics->gravity.x, (double)physics->gravity.y));
         mStatsLines.push_back(SPrintf_("Max Substeps:                     %d substeps", physics->maxSubsteps));
         mStatsLines.push_back(SPrintf_("CCD Min Size Factor:              %.3f units", (double)physics->ccdMinSizeFactor));
+        mStatsLines.push_back(SPrintf_("CCD Sweeps:                       %d sweeps (%d hits)", physics->nCcdSweeps, physics->nCcdHits));
         mStatsLines.push_back(SPrintf_("Substeps This Frame:              %d substeps", physics->nSubstepsThisFrame));
-        mStatsLines.push_back(SPrintf_("Solver Iterations:                %d interactions", physics->solverIterations));
+        mStatsLines.push_back(SPrintf_("Solver Iterations:                %d / %d iterations", physics->solverIterations, physics->velocityIterations * physics->nSubstepsThisFrame));
+        mStatsLines.push_back(SPrintf_("Solver Islands:                   %d islands (%d jobs)", physics->nSolverIslands, physics->nSolverJobs));
         mStatsLines.push_back(SPrintf_("Contacts Processed This Frame:    %" PRIu64 " contacts", (std::uint64_t)physics->nContactsProcessedThisFrame));
 
-        blockSizes.push_back(15);
+        blockSizes.push_back(18);
     }
 
     Font* consoleFontBold = assets->GetEngineDefaultFont(true);
@@ -64,6 +64,9 @@ void GameObject::SetParent(GameObject* newParent, bool keepWorld) noexcept
         else if (wasActive && !isActiveNow)                   OnDisable();
     }
 
+    // La particion del mundo solo agrupa objetos raiz
+    if (mScene) mScene->PartitionTouch_(this);
+
     // ajusta pose
     if (mTransform) {
         if (keepWorld) {
@@ -112,6 +115,13 @@ void GameObject::StartTransform()
 	mTransform->Start();
 }
 
+void GameObject::SetStreamingPinned(bool pinned) noexcept
+{
+    if (mPinned == pinned) return;
+    mPinned = pinned;
+    if (mScene) mScene->PartitionTouch_(this);
+}
+
 void GameObject::SetActive(bool a) noexcept
 {
     if (mActive == a) return;
@@ -209,6 +219,7 @@ void GameObject::OnDisable()
         if (auto* b = dynamic_cast<Behaviour*>(c.get())) {
             if (b->mAwoken && b->mStarted && b->enabled)
                 b->OnDisable();
+            b->StopAllCoroutines();
         }
     }
 
@@ -225,6 +236,7 @@ void GameObject::OnDestroy()
 {
     for (auto& c : components) if (c) {
         c->OnDestroy();   // desregistro, parar sonidos, etc.
+        if (auto* b = dynamic_cast<Behaviour*>(c.get())) b->StopAllCoroutines();
     }
 
     if (mParent) mParent->RemoveChild(this);
@@ -252,7 +264,7 @@ void GameObject::Register()
 void GameObject::FixedUpdate(float dt)
 {
     if (!mAwoken || !mStarted) return;
-    if (!mActive || !mParentActive) return;
+    if (!mActive || !mParentActive || mStreamedOut) return;
 
     for (auto& c : components)
     {
@@ -269,7 +281,7 @@ void GameObject::FixedUpdate(float dt)
 void GameObject::Update(float dt)
 {
     if (!mAwoken || !mStarted) return;
-    if (!mActive || !mParentActive) return;
+    if (!mActive || !mParentActive || mStreamedOut) return;
 
     for (auto& c : components)
     {
@@ -286,7 +298,7 @@ void GameObject::Update(float dt)
 void GameObject::Render()
 {
     if (!mAwoken || !mStarted) return;
-    if (!mActive || !mParentActive) return;
+    if (!mActive || !mParentActive || mStreamedOut) return;
 
     for (auto& c : components)
     {
@@ -300,104 +312,36 @@ void GameObject::Render()
     }
 }
 
-void GameObject::OnCollisionEnter(const CollisionInfo2D& info)
+void GameObject::DeliverCollisionEvents_(const CollisionEvent2D* events, size_t count)
 {
-    if (!mAwoken || !mStarted) return;
-    if (!mActive || !mParentActive) return;
-
-    for (auto& c : components)
+    for (size_t i = 0; i < count; ++i)
     {
-        if (!c) continue;
-        if (dynamic_cast<Transform*>(c.get())) continue;
+        // Se comprueba por evento: un callback puede desactivar el objeto
+        if (!mAwoken || !mStarted) return;
+        if (!mActive || !mParentActive) return;
 
-        if (auto* b = dynamic_cast<Behaviour*>(c.get())) {
-            if (b->mAwoken && b->mStarted && b->enabled)
-                b->OnCollisionEnter(info);
-        }
-    }
-}
-
-void GameObject::OnCollisionStay(const CollisionInfo2D& info)
-{
-    if (!mAwoken || !mStarted) return;
-    if (!mActive || !mParentActive) return;
+        const CollisionEvent2D& ev = events[i];
+        if ((mListenerHooks & ev.hook) == 0) continue;
 
-    for (auto& c : components)
-    {
-        if (!c) continue;
-        if (dynamic_cast<Transform*>(c.get())) continue;
-
-        if (auto* b = dynamic_cast<Behaviour*>(c.get())) {
-            if (b->mAwoken && b->mStarted && b->enabled)
-                b->OnCollisionStay(info);
-        }
-    }
-}
-
-void GameObject::OnCollisionExit(const CollisionInfo2D& info)
-{
-    if (!mAwoken || !mStarted) return;
-    if (!mActive || !mParentActive) return;
-
-    for (auto& c : components)
-    {
-        if (!c) continue;
-        if (dynamic_cast<Transform*>(c.get())) continue;
-
-        if (auto* b = dynamic_cast<Behaviour*>(c.get())) {
-            if (b->mAwoken && b->mStarted && b->enabled)
-                b->OnCollisionExit(info);
-        }
-    }
-}
-
-void GameObject::OnTriggerEnter(const CollisionInfo2D& info)
-{
-    if (!mAwoken || !mStarted) return;
-    if (!mActive || !mParentActive) return;
-
-    for (auto& c : components)
-    {
-        if (!c) continue;
-        if (dynamic_cast<Transform*>(c.get())) continue;
-
-        if (auto* b = dynamic_cast<Behaviour*>(c.get())) {
-            if (b->mAwoken && b->mStarted && b->enabled)
-                b->OnTriggerEnter(info);
-        }
-    }
-}
-
-void GameObject::OnTriggerStay(const CollisionInfo2D& info)
-{
-    if (!mAwoken || !mStarted) return;
-    if (!mActive || !mParentActive) return;
-
-    for (auto& c : components)
-    {
-        if (!c) continue;
-        if (dynamic_cast<Transform*>(c.get())) continue;
-
-        if (auto* b = dynamic_cast<Behaviour*>(c.get())) {
-            if (b->mAwoken && b->mStarted && b->enabled)
-                b->OnTriggerStay(info);
-        }
-    }
-}
-
-void GameObject::OnTriggerExit(const CollisionInfo2D& info)
-{
-    if (!mAwoken || !mStarted) return;
-    if (!mActive || !mParentActive) return;
-
-    for (auto& c : components)
-    {
-        if (!c) continue;
-        if (dynamic_cast<Transform*>(c.get())) continue;
-
-        if (auto* b = dynamic_cast<Behaviour*>(c.get())) {
-            if (b->mAwoken && b->mStarted && b->enabled)
-                b->OnTriggerExit(info);
+        // Por indice: un callback puede anadir componentes
+        for (size_t k = 0; k < mCollisionListeners.size(); ++k)
+        {
+            const CollisionListener l = mCollisionListeners[k];
+            if ((l.hooks & ev.hook) == 0) continue;
+
+            Behaviour* b = l.behaviour;
+            if (!b->mAwoken || !b->mStarted || !b->enabled) continue;
+
+            switch (ev.hook)
+            {
+            case kCollisionEnter: b->OnCollisionEnter(ev.info); break;
+            case kCollisionStay:  b->OnCollisionStay(ev.info); break;
+            case kCollisionExit:  b->OnCollisionExit(ev.info); break;
+            case kTriggerEnter:   b->OnTriggerEnter(ev.info); break;
+            case kTriggerStay:    b->OnTriggerStay(ev.info); break;
+            case kTriggerExit:    b->OnTriggerExit(ev.info); break;
+            default: break;
+            }
         }
     }
 }
@@ -0,0 +1,125 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+#include "ErrorHandler.h"
+
+// Un ParallelFor dentro de un job se ejecuta en serie (no hay colas anidadas)
+static thread_local bool tInsideJob = false;
+
+static constexpr int kMaxWorkers = 15;
+
+bool JobSystem::Init(const Config& cfg) noexcept
+{
+    Shutdown();
+
+    int workers = cfg.workerThreads;
+    if (workers == 0)
+    {
+        const int hw = (int)std::thread::hardware_concurrency();
+        workers = (hw > 1) ? hw - 1 : 0;
+    }
+    workers = std::clamp(workers, 0, kMaxWorkers);
+
+    mQuit = false;
+    mWorkers.reserve((size_t)workers);
+    for (int i = 0; i < workers; ++i)
+    {
+        try
+        {
+            mWorkers.emplace_back([this]() { WorkerLoop_(); });
+        }
+        catch (...)
+        {
+            // Sin hilos se sigue funcionando, solo que en serie
+            LogError("JobSystem::Init()", "Could not create all worker threads.");
+            break;
+        }
+    }
+
+    return true;
+}
+
+void JobSystem::Shutdown() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mQuit = true;
+    }
+    mWake.notify_all();
+
+    for (std::thread& t : mWorkers)
+        if (t.joinable()) t.join();
+
+    mWorkers.clear();
+    mJob = nullptr;
+    mJobCount = 0;
+    mActive = 0;
+}
+
+void JobSystem::RunJobs_(const std::function<void(uint32_t)>& job, uint32_t jobCount) noexcept
+{
+    tInsideJob = true;
+    for (uint32_t i = mNext.fetch_add(1); i < jobCount; i = mNext.fetch_add(1))
+        job(i);
+    tInsideJob = false;
+}
+
+void JobSystem::WorkerLoop_() noexcept
+{
+    uint64_t seen = 0;
+
+    while (true)
+    {
+        const std::function<void(uint32_t)>* job = nullptr;
+        uint32_t count = 0;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWake.wait(lock, [&]() { return mQuit || (mJob && mGeneration != seen); });
+            if (mQuit) return;
+
+            seen = mGeneration;
+            job = mJob;
+            count = mJobCount;
+            ++mActive;
+        }
+
+        RunJobs_(*job, count);
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            --mActive;
+        }
+        mDone.notify_one();
+    }
+}
+
+void JobSystem::ParallelFor(uint32_t jobCount, const std::function<void(uint32_t)>& job) noexcept
+{
+    if (jobCount == 0) return;
+
+    // Sin workers, un solo job o llamada anidada: en serie en este hilo
+    if (mWorkers.empty() || jobCount == 1 || tInsideJob)
+    {
+        for (uint32_t i = 0; i < jobCount; ++i) job(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mJob = &job;
+        mJobCount = jobCount;
+        mNext.store(0);
+        ++mGeneration;
+    }
+    mWake.notify_all();
+
+    // El que llama tambien trabaja
+    RunJobs_(job, jobCount);
+
+    // Repartidos todos: esperar a que los workers terminen el suyo y cerrar el lote
+    std::unique_lock<std::mutex> lock(mMutex);
+    mDone.wait(lock, [&]() { return mActive == 0; });
+    mJob = nullptr;
+    mJobCount = 0;
+}
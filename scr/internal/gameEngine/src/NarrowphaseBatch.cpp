@@ -0,0 +1,240 @@
+#include "NarrowphaseBatch.h"
+
+#include <cmath>
+#include <algorithm>
+
+// XENGINE_NO_SIMD fuerza el camino escalar (para comparar resultados)
+#if !defined(XENGINE_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define XENGINE_NARROW_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace narrow
+{
+    // Margen del filtro: solo se descarta lo claramente separado
+    static constexpr float kRel = 1e-4f;
+    static constexpr float kAbs = 1e-6f;
+
+    // =================== Lotes ===================
+    void CircleCircleBatch::Clear() noexcept
+    {
+        ax.clear(); ay.clear(); ar.clear();
+        bx.clear(); by.clear(); br.clear();
+    }
+
+    void CircleCircleBatch::Push(float cax, float cay, float ra, float cbx, float cby, float rb)
+    {
+        ax.push_back(cax); ay.push_back(cay); ar.push_back(ra);
+        bx.push_back(cbx); by.push_back(cby); br.push_back(rb);
+    }
+
+    void BoxCircleBatch::Clear() noexcept
+    {
+        bx.clear(); by.clear(); hx.clear(); hy.clear(); c.clear(); s.clear();
+        cx.clear(); cy.clear(); r.clear();
+    }
+
+    void BoxCircleBatch::Push(float boxX, float boxY, float halfX, float halfY, float cosA, float sinA,
+        float circleX, float circleY, float radius)
+    {
+        bx.push_back(boxX); by.push_back(boxY); hx.push_back(halfX); hy.push_back(halfY);
+        c.push_back(cosA); s.push_back(sinA);
+        cx.push_back(circleX); cy.push_back(circleY); r.push_back(radius);
+    }
+
+    void BoxBoxBatch::Clear() noexcept
+    {
+        ax.clear(); ay.clear(); ahx.clear(); ahy.clear(); ac.clear(); as.clear();
+        bx.clear(); by.clear(); bhx.clear(); bhy.clear(); bc.clear(); bs.clear();
+    }
+
+    void BoxBoxBatch::Push(float aX, float aY, float aHx, float aHy, float aCos, float aSin,
+        float bX, float bY, float bHx, float bHy, float bCos, float bSin)
+    {
+        ax.push_back(aX); ay.push_back(aY); ahx.push_back(aHx); ahy.push_back(aHy);
+        ac.push_back(aCos); as.push_back(aSin);
+        bx.push_back(bX); by.push_back(bY); bhx.push_back(bHx); bhy.push_back(bHy);
+        bc.push_back(bCos); bs.push_back(bSin);
+    }
+
+    // =================== Escalar (referencia y colas) ===================
+    // Las comparaciones se escriben como "separado" para que un NaN nunca descarte
+    static inline uint8_t CircleCircle1(const CircleCircleBatch& b, size_t i) noexcept
+    {
+        const float dx = b.bx[i] - b.ax[i];
+        const float dy = b.by[i] - b.ay[i];
+        const float d2 = dx * dx + dy * dy;
+        const float rr = b.ar[i] + b.br[i];
+        const float r2 = rr * rr;
+        return (d2 > r2 + r2 * kRel + kAbs) ? 0 : 1;
+    }
+
+    static inline uint8_t BoxCircle1(const BoxCircleBatch& b, size_t i) noexcept
+    {
+        const float rx = b.cx[i] - b.bx[i];
+        const float ry = b.cy[i] - b.by[i];
+        const float lx = rx * b.c[i] + ry * b.s[i];
+        const float ly = ry * b.c[i] - rx * b.s[i];
+        const float qx = std::min(std::max(lx, -b.hx[i]), b.hx[i]);
+        const float qy = std::min(std::max(ly, -b.hy[i]), b.hy[i]);
+        const float ex = lx - qx;
+        const float ey = ly - qy;
+        const float e2 = ex * ex + ey * ey;
+        const float r2 = b.r[i] * b.r[i];
+        return (e2 > r2 + r2 * kRel + kAbs) ? 0 : 1;
+    }
+
+    static inline bool Separated1(float dist, float ra, float rb) noexcept
+    {
+        const float sum = ra + rb;
+        return dist > sum + sum * kRel + kAbs;
+    }
+
+    static inline uint8_t BoxBox1(const BoxBoxBatch& b, size_t i) noexcept
+    {
+        const float tx = b.bx[i] - b.ax[i];
+        const float ty = b.by[i] - b.ay[i];
+
+        // |Ax.Bx| = |Ay.By| y |Ax.By| = |Ay.Bx|
+        const float cAB = std::fabs(b.ac[i] * b.bc[i] + b.as[i] * b.bs[i]);
+        const float sAB = std::fabs(b.as[i] * b.bc[i] - b.ac[i] * b.bs[i]);
+
+        const float tAx = std::fabs(tx * b.ac[i] + ty * b.as[i]);
+        const float tAy = std::fabs(ty * b.ac[i] - tx * b.as[i]);
+        const float tBx = std::fabs(tx * b.bc[i] + ty * b.bs[i]);
+        const float tBy = std::fabs(ty * b.bc[i] - tx * b.bs[i]);
+
+        if (Separated1(tAx, b.ahx[i], b.bhx[i] * cAB + b.bhy[i] * sAB)) return 0;
+        if (Separated1(tAy, b.ahy[i], b.bhx[i] * sAB + b.bhy[i] * cAB)) return 0;
+        if (Separated1(tBx, b.ahx[i] * cAB + b.ahy[i] * sAB, b.bhx[i])) return 0;
+        if (Separated1(tBy, b.ahx[i] * sAB + b.ahy[i] * cAB, b.bhy[i])) return 0;
+        return 1;
+    }
+
+#ifdef XENGINE_NARROW_SSE2
+    // =================== SSE2 (4 pares por vuelta) ===================
+    static inline __m128 Abs4(__m128 v) noexcept
+    {
+        return _mm_andnot_ps(_mm_set1_ps(-0.f), v);
+    }
+
+    // sum + sum * kRel + kAbs
+    static inline __m128 Bound4(__m128 sum) noexcept
+    {
+        return _mm_add_ps(_mm_add_ps(sum, _mm_mul_ps(sum, _mm_set1_ps(kRel))), _mm_set1_ps(kAbs));
+    }
+
+    static inline void StoreMaybe4(int sepMask, uint8_t* maybe) noexcept
+    {
+        for (int k = 0; k < 4; ++k)
+            maybe[k] = ((sepMask >> k) & 1) ? 0 : 1;
+    }
+
+    bool HasSimd() noexcept { return true; }
+
+    void Cull(const CircleCircleBatch& b, uint8_t* maybe) noexcept
+    {
+        const size_t n = b.Size();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m128 dx = _mm_sub_ps(_mm_loadu_ps(&b.bx[i]), _mm_loadu_ps(&b.ax[i]));
+            const __m128 dy = _mm_sub_ps(_mm_loadu_ps(&b.by[i]), _mm_loadu_ps(&b.ay[i]));
+            const __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+            const __m128 rr = _mm_add_ps(_mm_loadu_ps(&b.ar[i]), _mm_loadu_ps(&b.br[i]));
+            const __m128 r2 = _mm_mul_ps(rr, rr);
+            StoreMaybe4(_mm_movemask_ps(_mm_cmpgt_ps(d2, Bound4(r2))), maybe + i);
+        }
+        for (; i < n; ++i) maybe[i] = CircleCircle1(b, i);
+    }
+
+    void Cull(const BoxCircleBatch& b, uint8_t* maybe) noexcept
+    {
+        const size_t n = b.Size();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m128 c = _mm_loadu_ps(&b.c[i]);
+            const __m128 s = _mm_loadu_ps(&b.s[i]);
+            const __m128 hx = _mm_loadu_ps(&b.hx[i]);
+            const __m128 hy = _mm_loadu_ps(&b.hy[i]);
+            const __m128 rx = _mm_sub_ps(_mm_loadu_ps(&b.cx[i]), _mm_loadu_ps(&b.bx[i]));
+            const __m128 ry = _mm_sub_ps(_mm_loadu_ps(&b.cy[i]), _mm_loadu_ps(&b.by[i]));
+
+            const __m128 lx = _mm_add_ps(_mm_mul_ps(rx, c), _mm_mul_ps(ry, s));
+            const __m128 ly = _mm_sub_ps(_mm_mul_ps(ry, c), _mm_mul_ps(rx, s));
+
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 qx = _mm_min_ps(_mm_max_ps(lx, _mm_sub_ps(zero, hx)), hx);
+            const __m128 qy = _mm_min_ps(_mm_max_ps(ly, _mm_sub_ps(zero, hy)), hy);
+            const __m128 ex = _mm_sub_ps(lx, qx);
+            const __m128 ey = _mm_sub_ps(ly, qy);
+            const __m128 e2 = _mm_add_ps(_mm_mul_ps(ex, ex), _mm_mul_ps(ey, ey));
+
+            const __m128 r = _mm_loadu_ps(&b.r[i]);
+            const __m128 r2 = _mm_mul_ps(r, r);
+            StoreMaybe4(_mm_movemask_ps(_mm_cmpgt_ps(e2, Bound4(r2))), maybe + i);
+        }
+        for (; i < n; ++i) maybe[i] = BoxCircle1(b, i);
+    }
+
+    void Cull(const BoxBoxBatch& b, uint8_t* maybe) noexcept
+    {
+        const size_t n = b.Size();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m128 ac = _mm_loadu_ps(&b.ac[i]);
+            const __m128 as = _mm_loadu_ps(&b.as[i]);
+            const __m128 bc = _mm_loadu_ps(&b.bc[i]);
+            const __m128 bs = _mm_loadu_ps(&b.bs[i]);
+            const __m128 ahx = _mm_loadu_ps(&b.ahx[i]);
+            const __m128 ahy = _mm_loadu_ps(&b.ahy[i]);
+            const __m128 bhx = _mm_loadu_ps(&b.bhx[i]);
+            const __m128 bhy = _mm_loadu_ps(&b.bhy[i]);
+
+            const __m128 tx = _mm_sub_ps(_mm_loadu_ps(&b.bx[i]), _mm_loadu_ps(&b.ax[i]));
+            const __m128 ty = _mm_sub_ps(_mm_loadu_ps(&b.by[i]), _mm_loadu_ps(&b.ay[i]));
+
+            const __m128 cAB = Abs4(_mm_add_ps(_mm_mul_ps(ac, bc), _mm_mul_ps(as, bs)));
+            const __m128 sAB = Abs4(_mm_sub_ps(_mm_mul_ps(as, bc), _mm_mul_ps(ac, bs)));
+
+            const __m128 tAx = Abs4(_mm_add_ps(_mm_mul_ps(tx, ac), _mm_mul_ps(ty, as)));
+            const __m128 tAy = Abs4(_mm_sub_ps(_mm_mul_ps(ty, ac), _mm_mul_ps(tx, as)));
+            const __m128 tBx = Abs4(_mm_add_ps(_mm_mul_ps(tx, bc), _mm_mul_ps(ty, bs)));
+            const __m128 tBy = Abs4(_mm_sub_ps(_mm_mul_ps(ty, bc), _mm_mul_ps(tx, bs)));
+
+            const __m128 rbAx = _mm_add_ps(_mm_mul_ps(bhx, cAB), _mm_mul_ps(bhy, sAB));
+            const __m128 rbAy = _mm_add_ps(_mm_mul_ps(bhx, sAB), _mm_mul_ps(bhy, cAB));
+            const __m128 raBx = _mm_add_ps(_mm_mul_ps(ahx, cAB), _mm_mul_ps(ahy, sAB));
+            const __m128 raBy = _mm_add_ps(_mm_mul_ps(ahx, sAB), _mm_mul_ps(ahy, cAB));
+
+            __m128 sep = _mm_cmpgt_ps(tAx, Bound4(_mm_add_ps(ahx, rbAx)));
+            sep = _mm_or_ps(sep, _mm_cmpgt_ps(tAy, Bound4(_mm_add_ps(ahy, rbAy))));
+            sep = _mm_or_ps(sep, _mm_cmpgt_ps(tBx, Bound4(_mm_add_ps(raBx, bhx))));
+            sep = _mm_or_ps(sep, _mm_cmpgt_ps(tBy, Bound4(_mm_add_ps(raBy, bhy))));
+
+            StoreMaybe4(_mm_movemask_ps(sep), maybe + i);
+        }
+        for (; i < n; ++i) maybe[i] = BoxBox1(b, i);
+    }
+#else
+    // =================== Sin SIMD ===================
+    bool HasSimd() noexcept { return false; }
+
+    void Cull(const CircleCircleBatch& b, uint8_t* maybe) noexcept
+    {
+        for (size_t i = 0; i < b.Size(); ++i) maybe[i] = CircleCircle1(b, i);
+    }
+
+    void Cull(const BoxCircleBatch& b, uint8_t* maybe) noexcept
+    {
+        for (size_t i = 0; i < b.Size(); ++i) maybe[i] = BoxCircle1(b, i);
+    }
+
+    void Cull(const BoxBoxBatch& b, uint8_t* maybe) noexcept
+    {
+        for (size_t i = 0; i < b.Size(); ++i) maybe[i] = BoxBox1(b, i);
+    }
+#endif
+}
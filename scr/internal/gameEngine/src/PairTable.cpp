@@ -0,0 +1,113 @@
+#include "PairTable.h"
+
+#include <cstdint>
+
+static constexpr size_t kMinCapacity = 64;
+
+size_t PairTable::FindSlot_(uint64_t key) const noexcept
+{
+    if (mSlots.empty() || key == 0) return SIZE_MAX;
+
+    const size_t mask = mSlots.size() - 1;
+    size_t i = Hash_(key) & mask;
+
+    // Con carga <= 1/2 siempre hay un hueco que corta el sondeo
+    while (mSlots[i].key != 0)
+    {
+        if (mSlots[i].key == key) return i;
+        i = (i + 1) & mask;
+    }
+    return SIZE_MAX;
+}
+
+PairTable::Pair* PairTable::Find(uint64_t key) noexcept
+{
+    const size_t i = FindSlot_(key);
+    return (i == SIZE_MAX) ? nullptr : &mSlots[i];
+}
+
+const PairTable::Pair* PairTable::Find(uint64_t key) const noexcept
+{
+    const size_t i = FindSlot_(key);
+    return (i == SIZE_MAX) ? nullptr : &mSlots[i];
+}
+
+PairTable::Pair& PairTable::Touch(uint64_t key, bool& inserted)
+{
+    if ((mCount + 1) * 2 > mSlots.size()) Grow_();
+
+    const size_t mask = mSlots.size() - 1;
+    size_t i = Hash_(key) & mask;
+
+    while (mSlots[i].key != 0)
+    {
+        if (mSlots[i].key == key)
+        {
+            inserted = false;
+            return mSlots[i];
+        }
+        i = (i + 1) & mask;
+    }
+
+    mSlots[i] = Pair{};
+    mSlots[i].key = key;
+    ++mCount;
+    inserted = true;
+    return mSlots[i];
+}
+
+void PairTable::Erase(uint64_t key) noexcept
+{
+    size_t i = FindSlot_(key);
+    if (i == SIZE_MAX) return;
+
+    const size_t mask = mSlots.size() - 1;
+    size_t j = i;
+
+    // Desplazamiento hacia atras: sube los elementos del cluster que podrian
+    // quedarse sin camino hasta su slot de origen
+    while (true)
+    {
+        j = (j + 1) & mask;
+        if (mSlots[j].key == 0) break;
+
+        const size_t home = Hash_(mSlots[j].key) & mask;
+
+        // home ciclicamente en (i, j] => puede quedarse donde esta
+        const bool stays = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+        if (stays) continue;
+
+        mSlots[i] = mSlots[j];
+        i = j;
+    }
+
+    mSlots[i] = Pair{};
+    --mCount;
+}
+
+void PairTable::Clear() noexcept
+{
+    for (Pair& p : mSlots) p = Pair{};
+    mCount = 0;
+}
+
+void PairTable::Grow_()
+{
+    std::vector<Pair> old;
+    old.swap(mSlots);
+
+    const size_t cap = old.empty() ? kMinCapacity : old.size() * 2;
+    mSlots.assign(cap, Pair{});
+    mCount = 0;
+
+    const size_t mask = cap - 1;
+    for (const Pair& p : old)
+    {
+        if (p.key == 0) continue;
+
+        size_t i = Hash_(p.key) & mask;
+        while (mSlots[i].key != 0) i = (i + 1) & mask;
+        mSlots[i] = p;
+        ++mCount;
+    }
+}
@@ -6,6 +6,11 @@
 #include "Transform.h"
 #include "GameObject.h"
 #include "TimeManager.h"
+#include "ErrorHandler.h"
+#include "JobSystem.h"
+
+static constexpr size_t kMinRowsPerSolverJob = 64;  // por debajo no compensa despertar hilos
+static constexpr size_t kSolverJobsPerThread = 4;    // tramos de sobra para equilibrar carga
 
 static inline double NowSec_() noexcept
 {
@@ -14,10 +19,63 @@ static inline double NowSec_() noexcept
     return 0.0;
 }
 
+// =================== BodyStore ===================
+
+void PhysicsManager::BodyStore::Resize(size_t n)
+{
+    rb.resize(n); tr.resize(n); active.resize(n);
+    px.resize(n); py.resize(n); rot.resize(n); px0.resize(n); py0.resize(n); rot0.resize(n);
+    vx.resize(n); vy.resize(n); w.resize(n); sleepTime.resize(n); sleeping.resize(n); sleepIsland.resize(n);
+    forceX.resize(n); forceY.resize(n); accelX.resize(n); accelY.resize(n); torque.resize(n); angularAccel.resize(n);
+    ax.resize(n); ay.resize(n); aw.resize(n);
+    invM.resize(n); invI.resize(n); gravityScale.resize(n); linearDamping.resize(n); angularDamping.resize(n);
+    mx.resize(n); my.resize(n); mw.resize(n); dyn.resize(n); move.resize(n); solve.resize(n); lod.resize(n);
+}
+
+void PhysicsManager::BodyStore::CopyRow(size_t to, size_t from) noexcept
+{
+    rb[to] = rb[from]; tr[to] = tr[from]; active[to] = active[from];
+    px[to] = px[from]; py[to] = py[from]; rot[to] = rot[from]; px0[to] = px0[from]; py0[to] = py0[from]; rot0[to] = rot0[from];
+    vx[to] = vx[from]; vy[to] = vy[from]; w[to] = w[from]; sleepTime[to] = sleepTime[from]; sleeping[to] = sleeping[from];
+    sleepIsland[to] = sleepIsland[from];
+    forceX[to] = forceX[from]; forceY[to] = forceY[from]; accelX[to] = accelX[from]; accelY[to] = accelY[from];
+    torque[to] = torque[from]; angularAccel[to] = angularAccel[from];
+    ax[to] = ax[from]; ay[to] = ay[from]; aw[to] = aw[from];
+    invM[to] = invM[from]; invI[to] = invI[from]; gravityScale[to] = gravityScale[from];
+    linearDamping[to] = linearDamping[from]; angularDamping[to] = angularDamping[from];
+    mx[to] = mx[from]; my[to] = my[from]; mw[to] = mw[from]; dyn[to] = dyn[from]; move[to] = move[from];
+    solve[to] = solve[from];
+    lod[to] = lod[from];
+}
+
+// =================== Registro ===================
+
 void PhysicsManager::RegisterBody(RigidBody2D* b) noexcept
 {
     if (!b) return;
-    mBodies[b] = true;
+
+    auto& bs = mWorld.bodies;
+    if (!Owns_(b))
+    {
+        b->bodyIndex_ = bs.Size();
+        bs.Resize((size_t)b->bodyIndex_ + 1);
+        bs.rb[b->bodyIndex_] = b;
+        mWorld.version = ++mVersionCounter;
+
+        // Fila valida para SaveState aunque aun no haya pasado ningun Step
+        if (const Transform* tr = b->gameObject ? (Transform*)b->gameObject->transform : nullptr)
+        {
+            const Vec3 p = tr->position;
+            bs.px[b->bodyIndex_] = p.x;
+            bs.py[b->bodyIndex_] = p.y;
+            bs.rot[b->bodyIndex_] = tr->rotation->z;
+        }
+        bs.vx[b->bodyIndex_] = b->velocity_.x;
+        bs.vy[b->bodyIndex_] = b->velocity_.y;
+        bs.w[b->bodyIndex_] = b->angularVelocity_;
+        bs.lod[b->bodyIndex_] = 1.f;
+    }
+    bs.active[b->bodyIndex_] = 1;
 
     if (auto* col = b->gameObject->GetComponent<Collider2D>()) {
         if (col->shape == Collider2D::Shape::Circle) {
@@ -32,34 +90,343 @@ void PhysicsManager::RegisterBody(RigidBody2D* b) noexcept
     }
 }
 
+void PhysicsManager::SuspendWorld(const Scene* scene) noexcept
+{
+    if (!scene) { ClearAll(); return; }
+    mSuspendedWorlds[scene] = std::move(mWorld);
+    mWorld = World{};
+}
+
+bool PhysicsManager::ResumeWorld(const Scene* scene) noexcept
+{
+    auto it = mSuspendedWorlds.find(scene);
+    if (it == mSuspendedWorlds.end()) return false;
+    mWorld = std::move(it->second);
+    mSuspendedWorlds.erase(it);
+    return true;
+}
+
+void PhysicsManager::DiscardWorld(const Scene* scene) noexcept
+{
+    mSuspendedWorlds.erase(scene);
+}
+
 void PhysicsManager::RemoveBody(RigidBody2D* b) noexcept
 {
     if (!b) return;
-    mBodies.erase(b);
+
+    if (Owns_(b))
+    {
+        // El ultimo ocupa su fila
+        auto& bs = mWorld.bodies;
+        const uint32_t i = b->bodyIndex_;
+        const uint32_t last = bs.Size() - 1;
+        if (i != last)
+        {
+            bs.CopyRow(i, last);
+            bs.rb[i]->bodyIndex_ = i;
+        }
+        bs.Resize(last);
+        mWorld.version = ++mVersionCounter;
+    }
+    b->bodyIndex_ = UINT32_MAX;
+
+    if (auto* collision = CollisionManager::GetInstancePtr_NO_ERROR_MSG())
+        collision->ForgetBody_(b);
+}
+
+void PhysicsManager::SetEnableSleeping(bool enable) noexcept
+{
+    enableSleeping = enable;
+    if (enable) return;
+
+    for (RigidBody2D* rb : mWorld.bodies.rb)
+        if (rb) rb->WakeUp();
 }
 
 void PhysicsManager::SetBodyActive(RigidBody2D* b, bool active) noexcept
 {
-    if (!b) return;
-    auto it = mBodies.find(b);
-    if (it != mBodies.end()) it->second = active;
+    if (Owns_(b)) mWorld.bodies.active[b->bodyIndex_] = active ? 1 : 0;
 }
 
-int PhysicsManager::ComputeSubsteps_(float dt) noexcept
+// =================== Snapshots ===================
+
+bool PhysicsManager::SaveState(State& out) noexcept
 {
-    int steps = 1;
+    auto* collision = CollisionManager::GetInstancePtr();
+    if (!collision) return false;
+
+    // Copias de arrays contiguos (assign reutiliza la capacidad del State)
+    const auto& bs = mWorld.bodies;
+    out.px = bs.px;
+    out.py = bs.py;
+    out.rot = bs.rot;
+    out.vx = bs.vx;
+    out.vy = bs.vy;
+    out.w = bs.w;
+    out.sleepTime = bs.sleepTime;
+    out.sleeping = bs.sleeping;
+    out.sleepIsland = bs.sleepIsland;
+    out.forceX = bs.forceX;
+    out.forceY = bs.forceY;
+    out.accelX = bs.accelX;
+    out.accelY = bs.accelY;
+    out.torque = bs.torque;
+    out.angularAccel = bs.angularAccel;
+
+    out.pairs = collision->mWorld.pairs;
+    out.collisionStamp = collision->mWorld.stamp;
+
+    out.bodiesVersion = mWorld.version;
+    out.collidersVersion = collision->mWorld.version;
+    out.valid = true;
+    return true;
+}
+
+bool PhysicsManager::RestoreState(const State& in) noexcept
+{
+    auto* collision = CollisionManager::GetInstancePtr();
+    if (!collision) return false;
 
-    for (auto& [rb, active] : mBodies)
+    if (!in.valid || in.bodiesVersion != mWorld.version || in.collidersVersion != collision->mWorld.version)
     {
-        if (!rb || !active) continue;
-        if (rb->GetBodyType() != RigidBody2D::BodyType::Dynamic) continue;
-        if (rb->GetCollisionDetection() != RigidBody2D::CollisionDetection::Continuous) continue;
+        LogError("PhysicsManager::RestoreState()", "State was saved with a different set of bodies or colliders.");
+        return false;
+    }
+
+    auto& bs = mWorld.bodies;
+    bs.px = in.px;
+    bs.py = in.py;
+    bs.rot = in.rot;
+    bs.vx = in.vx;
+    bs.vy = in.vy;
+    bs.w = in.w;
+    bs.sleepTime = in.sleepTime;
+    bs.sleeping = in.sleeping;
+    bs.sleepIsland = in.sleepIsland;
+    bs.forceX = in.forceX;
+    bs.forceY = in.forceY;
+    bs.accelX = in.accelX;
+    bs.accelY = in.accelY;
+    bs.torque = in.torque;
+    bs.angularAccel = in.angularAccel;
+
+    collision->RestorePairs_(in.pairs, in.collisionStamp);
+
+    // Los Transform y RigidBody2D son lo que ven el render y los scripts.
+    // Los inactivos no se simulan: se quedan como esten.
+    for (uint32_t i = 0; i < bs.Size(); ++i)
+    {
+        if (!bs.active[i]) continue;
+
+        RigidBody2D* rb = bs.rb[i];
+        rb->velocity_ = { bs.vx[i], bs.vy[i] };
+        rb->angularVelocity_ = bs.w[i];
+        rb->sleeping_ = bs.sleeping[i] != 0;
+        rb->sleepTime_ = bs.sleepTime[i];
+        rb->accumForce_ = { bs.forceX[i], bs.forceY[i] };
+        rb->accumAccel_ = { bs.accelX[i], bs.accelY[i] };
+        rb->accumTorque_ = bs.torque[i];
+        rb->accumAngularAccel_ = bs.angularAccel[i];
+
+        Transform* tr = rb->gameObject ? (Transform*)rb->gameObject->transform : nullptr;
+        if (!tr) continue;
+
+        Vec3 p = tr->position;
+        if (p.x != bs.px[i] || p.y != bs.py[i])
+        {
+            p.x = bs.px[i];
+            p.y = bs.py[i];
+            tr->position = p;
+        }
+
+        Vec3 r = tr->rotation;
+        if (r.z != bs.rot[i])
+        {
+            r.z = bs.rot[i];
+            tr->rotation = r;
+        }
+    }
+
+    return true;
+}
+
+// =================== Estado por paso ===================
 
+void PhysicsManager::RefreshBody_(uint32_t i) noexcept
+{
+    auto& bs = mWorld.bodies;
+    const RigidBody2D* rb = bs.rb[i];
+
+    const auto type = rb->GetBodyType();
+    const auto c = rb->GetConstraints();
+    // Con LOD a 0 (Reduced sin tick o Frozen) este paso no se integra, pero sigue en
+    // el solver con su masa: para los vecinos no es una pared
+    const bool awake = bs.active[i] && bs.tr[i] && !rb->IsSleeping();
+    const bool stepping = awake && bs.lod[i] > 0.f;
+
+    bs.invM[i] = rb->InvMass_();
+    bs.invI[i] = rb->InvInertia_();
+    bs.gravityScale[i] = rb->GetGravityScale();
+    bs.mx[i] = RigidBody2D::Has_(c, RigidBody2D::Constraints::FreezePosX) ? 0.f : 1.f;
+    bs.my[i] = RigidBody2D::Has_(c, RigidBody2D::Constraints::FreezePosY) ? 0.f : 1.f;
+    bs.mw[i] = RigidBody2D::Has_(c, RigidBody2D::Constraints::FreezeRot) ? 0.f : 1.f;
+
+    // Kinematic: ignora fuerzas y damping, solo usa v/w. Static: ni se mueve ni integra.
+    const bool dynamic = type == RigidBody2D::BodyType::Dynamic;
+    bs.dyn[i] = (dynamic && stepping) ? 1.f : 0.f;
+    bs.move[i] = ((dynamic || type == RigidBody2D::BodyType::Kinematic) && stepping) ? 1.f : 0.f;
+    bs.solve[i] = (dynamic && awake) ? 1.f : 0.f;
+    bs.linearDamping[i] = dynamic ? rb->GetLinearDamping() : 0.f;
+    bs.angularDamping[i] = dynamic ? rb->GetAngularDamping() : 0.f;
+
+    if (bs.move[i] == 0.f)
+    {
+        // Saltado por LOD: mantiene las mascaras (el solver lo mueve; con h = 0 no se integra)
+        if (bs.solve[i] == 0.f) bs.mx[i] = bs.my[i] = bs.mw[i] = 0.f;
+        bs.ax[i] = bs.ay[i] = bs.aw[i] = 0.f;
+    }
+}
+
+void PhysicsManager::WakeBody_(RigidBody2D* rb) noexcept
+{
+    rb->WakeUp();
+    if (Owns_(rb)) RefreshBody_(rb->bodyIndex_);
+}
+
+void PhysicsManager::GatherBodies_() noexcept
+{
+    auto& bs = mWorld.bodies;
+    const uint32_t n = bs.Size();
+
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        RigidBody2D* rb = bs.rb[i];
         GameObject* go = rb->gameObject;
-        if (!go) continue;
+        Transform* tr = (bs.active[i] && go) ? (Transform*)go->transform : nullptr;
+        bs.tr[i] = tr;
+        bs.lod[i] = go ? go->mLodScale : 1.f;
+
+        if (tr)
+        {
+            const Vec3 p = tr->position;
+            bs.px[i] = bs.px0[i] = p.x;
+            bs.py[i] = bs.py0[i] = p.y;
+            bs.rot[i] = bs.rot0[i] = tr->rotation->z;
+        }
+
+        bs.vx[i] = rb->velocity_.x;
+        bs.vy[i] = rb->velocity_.y;
+        bs.w[i] = rb->angularVelocity_;
+
+        const float invM = rb->InvMass_();
+        bs.ax[i] = rb->accumForce_.x * invM + rb->accumAccel_.x;
+        bs.ay[i] = rb->accumForce_.y * invM + rb->accumAccel_.y;
+        bs.aw[i] = rb->accumTorque_ * rb->InvInertia_() + rb->accumAngularAccel_;
+
+        RefreshBody_(i);
+
+        // Los dormidos y los que no avanzan este paso se quedan como estan (con lo acumulado)
+        if (bs.active[i] && !rb->IsSleeping() && bs.lod[i] > 0.f)
+        {
+            rb->accumForce_ = { 0,0 };
+            rb->accumAccel_ = { 0,0 };
+            rb->accumTorque_ = 0.f;
+            rb->accumAngularAccel_ = 0.f;
+        }
+
+        if (rb->GetBodyType() == RigidBody2D::BodyType::Static && bs.active[i])
+        {
+            bs.vx[i] = bs.vy[i] = bs.w[i] = 0.f;
+        }
+    }
+
+    mInStep = true;
+}
+
+void PhysicsManager::WriteBackBodies_() noexcept
+{
+    mInStep = false;
+
+    auto& bs = mWorld.bodies;
+    const uint32_t n = bs.Size();
+
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        if (!bs.tr[i]) continue;
+        RigidBody2D* rb = bs.rb[i];
+
+        // Sin WakeUp: se decide en UpdateSleep_
+        rb->velocity_ = { bs.vx[i], bs.vy[i] };
+        rb->angularVelocity_ = bs.w[i];
+
+        // Un solo SetWorldPosition / rotacion por cuerpo y paso fijo, y solo si se ha movido
+        Transform* tr = bs.tr[i];
+        if (bs.px[i] != bs.px0[i] || bs.py[i] != bs.py0[i])
+        {
+            Vec3 p = tr->position;
+            p.x = bs.px[i];
+            p.y = bs.py[i];
+            tr->position = p;
+        }
+        if (bs.rot[i] != bs.rot0[i])
+        {
+            Vec3 r = tr->rotation;
+            r.z = bs.rot[i];
+            tr->rotation = r;
+        }
+    }
+}
+
+bool PhysicsManager::BodyPose_(const RigidBody2D* rb, const Transform* tr, Vec3& pos, float& rotZ) const noexcept
+{
+    if (!mInStep || !tr || !Owns_(rb)) return false;
+
+    const auto& bs = mWorld.bodies;
+    const uint32_t i = rb->bodyIndex_;
+    if (!bs.tr[i]) return false;
+
+    // El Transform (el del cuerpo o uno hijo) sigue como al recoger: se le aplica
+    // el movimiento rigido del cuerpo en lo que va de paso
+    pos = tr->position;
+    rotZ = tr->rotation->z;
+
+    const float dRot = bs.rot[i] - bs.rot0[i];
+    float rx = pos.x - bs.px0[i];
+    float ry = pos.y - bs.py0[i];
+    if (dRot != 0.f && (rx != 0.f || ry != 0.f))
+    {
+        const float a = math::Deg2Rad(dRot);
+        const float c = std::cos(a), s = std::sin(a);
+        const float x = c * rx - s * ry;
+        ry = s * rx + c * ry;
+        rx = x;
+    }
+
+    pos.x = bs.px[i] + rx;
+    pos.y = bs.py[i] + ry;
+    rotZ += dRot;
+    return true;
+}
+
+void PhysicsManager::GatherContinuous_() noexcept
+{
+    mCcdBodies.clear();
+
+    const auto& bs = mWorld.bodies;
+    const uint32_t n = bs.Size();
+
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        if (bs.dyn[i] == 0.f) continue;
+
+        RigidBody2D* rb = bs.rb[i];
+        // El tick de un cuerpo con LOD avanza varios pasos de golpe: se barre aunque sea Discrete
+        const bool lodOnly = rb->GetCollisionDetection() != RigidBody2D::CollisionDetection::Continuous;
+        if (lodOnly && bs.lod[i] <= 1.f) continue;
 
-        auto* col = go->GetComponent<Collider2D>();
-        if (!col) continue;
+        auto* col = rb->gameObject->GetComponent<Collider2D>();
+        if (!col || !col->enabled || col->isTrigger) continue;
 
         // tamao caracterstico
         float size = 1.0f;
@@ -73,13 +440,33 @@ int PhysicsManager::ComputeSubsteps_(float dt) noexcept
             size = std::max(0.001f, std::min(s.x, s.y));
         }
 
-        const Vec2 v = rb->GetVelocity();
-        const float speed = std::sqrt(v.x * v.x + v.y * v.y);
-        const float dist = speed * dt;
+        CcdBody cb;
+        cb.body = i;
+        cb.col = col;
+        cb.minMove = std::max(0.001f, size * ccdMinSizeFactor);
+        cb.lodOnly = lodOnly;
+        mCcdBodies.push_back(cb);
+    }
+}
+
+int PhysicsManager::ComputeSubsteps_(float dt) noexcept
+{
+    // Sin substepping global cada cuerpo rapido se barre por su cuenta
+    if (!ccdSubstepping) return 1;
+
+    int steps = 1;
+
+    const auto& bs = mWorld.bodies;
+    for (const CcdBody& cb : mCcdBodies)
+    {
+        if (cb.lodOnly) continue;
 
-        const float denom = std::max(0.001f, size * ccdMinSizeFactor);
-        const int need = (int)std::ceil(dist / denom);
+        // Lo que avanza en el paso, con los pasos de LOD que recupera
+        const uint32_t i = cb.body;
+        const float speed = std::sqrt(bs.vx[i] * bs.vx[i] + bs.vy[i] * bs.vy[i]);
+        const float dist = speed * dt * bs.lod[i];
 
+        const int need = (int)std::ceil(dist / cb.minMove);
         steps = std::max(steps, need);
     }
 
@@ -89,290 +476,596 @@ int PhysicsManager::ComputeSubsteps_(float dt) noexcept
 
 void PhysicsManager::Integrate_(float dt) noexcept
 {
-    for (auto& [rb, active] : mBodies)
+    auto& bs = mWorld.bodies;
+    const size_t n = bs.Size();
+
+    // Coeficientes por cuerpo en vez de ramas: el compilador puede vectorizar el bucle.
+    // Static y dormidos: dyn = move = 0 y mascaras a 0. Kinematic: dyn = 0, sin damping.
+    // LOD: cada cuerpo avanza dt * lod (los pasos que se ha saltado, de golpe).
+    const float gx = gravity.x, gy = gravity.y;
+    const float degPerRad = math::Rad2Deg(1.0f);
+
+    float* vx = bs.vx.data();
+    float* vy = bs.vy.data();
+    float* w = bs.w.data();
+    float* px = bs.px.data();
+    float* py = bs.py.data();
+    float* rot = bs.rot.data();
+    const float* ax = bs.ax.data();
+    const float* ay = bs.ay.data();
+    const float* aw = bs.aw.data();
+    const float* gs = bs.gravityScale.data();
+    const float* ld = bs.linearDamping.data();
+    const float* ad = bs.angularDamping.data();
+    const float* mx = bs.mx.data();
+    const float* my = bs.my.data();
+    const float* mw = bs.mw.data();
+    const float* dyn = bs.dyn.data();
+    const float* move = bs.move.data();
+    const float* lod = bs.lod.data();
+
+    for (size_t i = 0; i < n; ++i)
     {
-        if (!rb || !active) continue;
+        const float h = dt * lod[i];
 
-        GameObject* go = rb->gameObject;
-        if (!go) { rb->ClearForces(); continue; }
+        // acel = (F/m) + accel + gravedad; constraints y damping como factores
+        const float kl = std::max(0.f, 1.f - ld[i] * h);
+        const float ka = std::max(0.f, 1.f - ad[i] * h);
 
-        auto* tr = go->GetComponent<Transform>();
-        if (!tr) { rb->ClearForces(); continue; }
+        vx[i] = (vx[i] + (ax[i] + gx * gs[i]) * dyn[i] * h) * mx[i] * kl;
+        vy[i] = (vy[i] + (ay[i] + gy * gs[i]) * dyn[i] * h) * my[i] * kl;
+        w[i] = (w[i] + aw[i] * dyn[i] * h) * mw[i] * ka;
 
-        const auto type = rb->GetBodyType();
-        const auto c = rb->GetConstraints();
+        px[i] += vx[i] * move[i] * h;
+        py[i] += vy[i] * move[i] * h;
+        rot[i] += w[i] * move[i] * h * degPerRad;
+    }
 
-        // Static: no se mueve ni integra
-        if (type == RigidBody2D::BodyType::Static)
-        {
-            rb->SetVelocity({ 0,0 });
-            rb->SetAngularVelocity(0.f);
-            rb->ClearForces();
-            continue;
-        }
+    // Los acumuladores solo cuentan en el primer substep
+    std::fill(bs.ax.begin(), bs.ax.end(), 0.f);
+    std::fill(bs.ay.begin(), bs.ay.end(), 0.f);
+    std::fill(bs.aw.begin(), bs.aw.end(), 0.f);
+}
 
-        Vec2 v = rb->GetVelocity();
-        float w = rb->GetAngularVelocity();
+void PhysicsManager::SweepContinuous_() noexcept
+{
+    auto* collision = CollisionManager::GetInstancePtr();
+    if (!collision || mCcdBodies.empty()) return;
 
-        // Kinematic: ignora fuerzas, solo usa v/w
-        if (type == RigidBody2D::BodyType::Kinematic)
-        {
-            // constraints
-            if ((c & RigidBody2D::Constraints::FreezePosX) != RigidBody2D::Constraints::None) v.x = 0.f;
-            if ((c & RigidBody2D::Constraints::FreezePosY) != RigidBody2D::Constraints::None) v.y = 0.f;
-            if ((c & RigidBody2D::Constraints::FreezeRot) != RigidBody2D::Constraints::None) w = 0.f;
-
-            Vec3 pos = tr->position;
-            pos.x += v.x * dt;
-            pos.y += v.y * dt;
-            tr->position = pos;
-
-            Vec3 rot = tr->rotation;
-            rot.z += (w * dt) * (180.0f / 3.1415926535f);
-            tr->rotation = rot;
-
-            rb->SetVelocity(v);
-            rb->SetAngularVelocity(w);
-            rb->ClearForces();
-            continue;
-        }
+    auto& bs = mWorld.bodies;
 
-        // Dynamic:
-        const float invM = rb->InvMass_();
-        const float invI = rb->InvInertia_();
+    // Penetracion con la que se deja al cuerpo en el impacto: lo bastante para que
+    // el narrowphase genere el contacto y el solver haga el rebote, sin bias
+    const float skin = std::max(penetrationSlop, 1e-3f);
 
-        // acel = (F/m) + accel + gravedad
-        Vec2 a = rb->accumForce_ * invM;
-        a += rb->accumAccel_;
-        a += gravity * rb->GetGravityScale();
+    for (const CcdBody& cb : mCcdBodies)
+    {
+        const uint32_t i = cb.body;
+        if (bs.dyn[i] == 0.f) continue;
+
+        const Vec2 delta{ bs.px[i] - cb.start.x, bs.py[i] - cb.start.y };
+        const float dist = math::Length(delta);
+        if (dist <= cb.minMove) continue;
+
+        // Barrido lineal de la forma (sin rotacion) desde donde estaba
+        ++nCcdSweeps;
+        float toi = 0.f;
+        Vec2 n{ 0.f, 0.f };
+        if (!collision->SweepCollider_(cb.col, bs.rb[i], delta, toi, n)) continue;
+        ++nCcdHits;
+
+        // Hasta el impacto, mas lo que quedaba de movimiento tangente a la superficie
+        // (n apunta hacia el cuerpo); la velocidad la corrige el solver con el contacto
+        const Vec2 dir = delta * (1.f / dist);
+        Vec2 rest = delta - dir * toi;
+        rest = rest - n * math::Dot(rest, n);
+
+        bs.px[i] = cb.start.x + dir.x * toi + rest.x - n.x * skin;
+        bs.py[i] = cb.start.y + dir.y * toi + rest.y - n.y * skin;
+    }
+}
 
-        // constraints afectan aceleracin/velocidad
-        if ((c & RigidBody2D::Constraints::FreezePosX) != RigidBody2D::Constraints::None) { a.x = 0.f; v.x = 0.f; }
-        if ((c & RigidBody2D::Constraints::FreezePosY) != RigidBody2D::Constraints::None) { a.y = 0.f; v.y = 0.f; }
+uint32_t PhysicsManager::SolverBodyOf_(RigidBody2D* rb) noexcept
+{
+    if (!rb) return 0;
+    if (rb->solverStamp_ == mSolverStamp) return rb->solverIndex_;
 
-        // angular accel
-        float angA = rb->accumTorque_ * invI + rb->accumAngularAccel_;
-        if ((c & RigidBody2D::Constraints::FreezeRot) != RigidBody2D::Constraints::None) { angA = 0.f; w = 0.f; }
+    SolverBody sb;
+    sb.rb = rb;
+    sb.v = rb->GetVelocity();
+    sb.w = rb->GetAngularVelocity();
 
-        v += a * dt;
-        w += angA * dt;
+    // Dormido (y sin nada que lo despierte) o fuera del store: inmovil como un estatico
+    if (Owns_(rb))
+    {
+        const auto& bs = mWorld.bodies;
+        const uint32_t i = rb->bodyIndex_;
+        sb.body = i;
+        sb.v = { bs.vx[i], bs.vy[i] };
+        sb.w = bs.w[i];
 
-        // damping
-        const float ld = rb->GetLinearDamping();
-        if (ld > 0.f) {
-            const float k = std::max(0.f, 1.f - ld * dt);
-            v *= k;
-        }
-        const float ad = rb->GetAngularDamping();
-        if (ad > 0.f) {
-            const float k = std::max(0.f, 1.f - ad * dt);
-            w *= k;
+        if (bs.solve[i] != 0.f)
+        {
+            sb.invM = bs.invM[i];
+            sb.invI = bs.invI[i] * bs.mw[i];
+            sb.linearMask = { bs.mx[i], bs.my[i] };
         }
-
-        // integrar transform
-        Vec3 pos = tr->position;
-        pos.x += v.x * dt;
-        pos.y += v.y * dt;
-        tr->position = pos;
-
-        Vec3 rot = tr->rotation;
-        rot.z += (w * dt) * (180.0f / 3.1415926535f);
-        tr->rotation = rot;
-
-        rb->SetVelocity(v);
-        rb->SetAngularVelocity(w);
-
-        rb->ClearForces();
     }
-}
 
-Vec2 PhysicsManager::ColliderCenterWorld_(const Collider2D* c) noexcept
-{
-    if (!c) return { 0,0 };
-    if (c->GetShape() == Collider2D::Shape::Circle) return c->WorldCircle().center;
-    return c->WorldOBB().center;
+    rb->solverStamp_ = mSolverStamp;
+    rb->solverIndex_ = (uint32_t)mSolverBodies.size();
+    mSolverBodies.push_back(sb);
+    return rb->solverIndex_;
 }
 
-void PhysicsManager::SolveContacts_(const std::vector<NarrowContact>& contacts, float dt) noexcept
+void PhysicsManager::PrepareContacts_(const std::vector<NarrowContact>& contacts, float dt) noexcept
 {
     constexpr float kRestitutionThreshold = 0.5f;
     constexpr float beta = 0.10f; // bias suave (0.05..0.15)
 
+    mContactRows.clear();
+    mPositionRows.clear();
+    mSolverBodies.clear();
+    mSolverBodies.push_back(SolverBody{});  // 0: objetos sin RigidBody2D (inmoviles)
+    ++mSolverStamp;
+
+    auto* collision = CollisionManager::GetInstancePtr();
+
     for (const auto& c : contacts)
     {
         if (!c.a || !c.b) continue;
         if (c.isTriggerPair) continue;
 
-        auto* rbA = c.a->GetComponent<RigidBody2D>();
-        auto* rbB = c.b->GetComponent<RigidBody2D>();
+        RigidBody2D* rbA = c.bodyA;
+        RigidBody2D* rbB = c.bodyB;
         if (!rbA && !rbB) continue;
 
-        auto* trA = c.a->GetComponent<Transform>();
-        auto* trB = c.b->GetComponent<Transform>();
-        if (!trA || !trB) continue;
+        // Un dormido solo se despierta si lo toca algo que se mueve
+        // (su isla entera despierta al final del paso)
+        const bool movingA = IsMoving_(rbA);
+        const bool movingB = IsMoving_(rbB);
+        if (rbA && rbA->IsSleeping() && movingB) WakeBody_(rbA);
+        if (rbB && rbB->IsSleeping() && movingA) WakeBody_(rbB);
+
+        const uint32_t ia = SolverBodyOf_(rbA);
+        const uint32_t ib = SolverBodyOf_(rbB);
+        const SolverBody& A = mSolverBodies[ia];
+        const SolverBody& B = mSolverBodies[ib];
+
+        const float invMassSum = A.invM + B.invM;
+        if (invMassSum <= 0.f) continue;
 
         Vec2 n = c.contact.normalA;      // A->B
-        const float pen = c.contact.penetration;
-        const Vec2 p = c.contact.point;
 
-        const Vec2 centerA = (c.colA ? ColliderCenterWorld_(c.colA) : Vec2{ trA->position->x, trA->position->y });
-        const Vec2 centerB = (c.colB ? ColliderCenterWorld_(c.colB) : Vec2{ trB->position->x, trB->position->y });
+        const Vec2 centerA = c.centerA;
+        const Vec2 centerB = c.centerB;
 
         if (math::Dot(centerB - centerA, n) < 0.f) n = -n;
 
-        const float invMA = (rbA && rbA->GetBodyType() == RigidBody2D::BodyType::Dynamic) ? rbA->InvMass_() : 0.f;
-        const float invMB = (rbB && rbB->GetBodyType() == RigidBody2D::BodyType::Dynamic) ? rbB->InvMass_() : 0.f;
-        float invIA = (rbA && rbA->GetBodyType() == RigidBody2D::BodyType::Dynamic) ? rbA->InvInertia_() : 0.f;
-        float invIB = (rbB && rbB->GetBodyType() == RigidBody2D::BodyType::Dynamic) ? rbB->InvInertia_() : 0.f;
+        // Correccion de posicion: una por contacto, con su penetracion maxima
+        mPositionRows.push_back({ ia, ib, n, c.contact.penetration });
 
-        auto consA = rbA ? rbA->GetConstraints() : RigidBody2D::Constraints::None;
-        auto consB = rbB ? rbB->GetConstraints() : RigidBody2D::Constraints::None;
+        // restitucin
+        float e = 0.f;
+        if (rbA) e = std::max(e, rbA->GetRestitution());
+        if (rbB) e = std::max(e, rbB->GetRestitution());
 
-        if ((consA & RigidBody2D::Constraints::FreezeRot) != RigidBody2D::Constraints::None) invIA = 0.f;
-        if ((consB & RigidBody2D::Constraints::FreezeRot) != RigidBody2D::Constraints::None) invIB = 0.f;
+        // Impulsos del paso anterior de este par
+        PairTable::Pair* pair = collision ? collision->FindPair_(c.a, c.b) : nullptr;
 
-        const float invMassSum = invMA + invMB;
-        if (invMassSum <= 0.f) continue;
+        ContactManifold single;
+        const ContactManifold* manifold = &c.manifold;
+        if (manifold->count == 0)
+        {
+            single.points[0] = { c.contact.point, c.contact.penetration, 0u };
+            single.count = 1;
+            manifold = &single;
+        }
 
-        // rA/rB desde COM a contacto
-        const Vec2 rA = p - centerA;
-        const Vec2 rB = p - centerB;
+        for (const ManifoldPoint& mp : *manifold)
+        {
+            ContactRow row;
+            row.bodyA = ia;
+            row.bodyB = ib;
+            row.pair = pair;
+            row.colA = c.colA;
+            row.colB = c.colB;
+            row.id = mp.id;
+            row.n = n;
+
+            // rA/rB desde COM a contacto
+            row.rA = mp.point - centerA;
+            row.rB = mp.point - centerB;
+            row.rnA = Cross(row.rA, n);
+            row.rnB = Cross(row.rB, n);
+
+            const float denom = invMassSum + (row.rnA * row.rnA) * A.invI + (row.rnB * row.rnB) * B.invI;
+            if (denom <= 1e-8f) continue;
+            row.normalMass = 1.f / denom;
+
+            // Rebote con la velocidad de llegada (antes de resolver) + bias (Baumgarte)
+            const Vec2 rv = (B.v + Perp(B.w, row.rB)) - (A.v + Perp(A.w, row.rA));
+            const float velAlongN = math::Dot(rv, n);
+
+            row.bias = (beta / dt) * std::max(mp.penetration - penetrationSlop, 0.f);
+            row.restitution = (-velAlongN >= kRestitutionThreshold) ? -e * velAlongN : 0.f;
+
+            row.normalImpulse = pair ? pair->FindImpulse(row.colA, row.colB, row.id) : 0.f;
+
+            mContactRows.push_back(row);
+        }
+    }
 
-        Vec2 vA = rbA ? rbA->GetVelocity() : Vec2{ 0,0 };
-        Vec2 vB = rbB ? rbB->GetVelocity() : Vec2{ 0,0 };
-        float wA = rbA ? rbA->GetAngularVelocity() : 0.f;
-        float wB = rbB ? rbB->GetAngularVelocity() : 0.f;
+    BuildSolverIslands_();
+}
 
-        const Vec2 velAtA = vA + Perp(wA, rA);
-        const Vec2 velAtB = vB + Perp(wB, rB);
-        const Vec2 rv = velAtB - velAtA;
+void PhysicsManager::BuildSolverIslands_() noexcept
+{
+    // Islas del substep: componentes conexas de los cuerpos movibles unidos por
+    // contactos. Estaticos, cinematicos y dormidos (invM = 0) separan islas porque
+    // el solver nunca escribe en ellos.
+    const uint32_t nb = (uint32_t)mSolverBodies.size();
+    mSolverParent.resize(nb);
+    for (uint32_t i = 0; i < nb; ++i) mSolverParent[i] = i;
+
+    for (const PositionRow& row : mPositionRows)
+    {
+        if (mSolverBodies[row.bodyA].invM <= 0.f || mSolverBodies[row.bodyB].invM <= 0.f) continue;
+        const uint32_t ra = FindRoot_(mSolverParent, row.bodyA);
+        const uint32_t rb = FindRoot_(mSolverParent, row.bodyB);
+        if (ra != rb) mSolverParent[ra] = rb;
+    }
 
-        const float velAlongN = math::Dot(rv, n);
+    // Numeracion por orden de aparicion (determinista) y filas agrupadas por isla
+    // sin cambiar su orden relativo: cada isla se resuelve igual que en serie
+    for (SolverBody& sb : mSolverBodies) sb.island = UINT32_MAX;
 
-        // restitucin
-        float e = 0.f;
-        if (rbA) e = std::max(e, rbA->GetRestitution());
-        if (rbB) e = std::max(e, rbB->GetRestitution());
-        if (-velAlongN < kRestitutionThreshold) e = 0.f;
+    uint32_t islandCount = 0;
+    auto islandOf = [&](uint32_t bodyA, uint32_t bodyB)
+        {
+            const uint32_t body = (mSolverBodies[bodyA].invM > 0.f) ? bodyA : bodyB;
+            SolverBody& root = mSolverBodies[FindRoot_(mSolverParent, body)];
+            if (root.island == UINT32_MAX) root.island = islandCount++;
+            return root.island;
+        };
 
-        const float raCn = Cross(rA, n);
-        const float rbCn = Cross(rB, n);
+    mRowIsland.resize(mContactRows.size());
+    for (size_t r = 0; r < mContactRows.size(); ++r)
+        mRowIsland[r] = islandOf(mContactRows[r].bodyA, mContactRows[r].bodyB);
 
-        const float denom = invMassSum + (raCn * raCn) * invIA + (rbCn * rbCn) * invIB;
-        if (denom <= 1e-8f) continue;
+    mPositionIsland.resize(mPositionRows.size());
+    for (size_t r = 0; r < mPositionRows.size(); ++r)
+        mPositionIsland[r] = islandOf(mPositionRows[r].bodyA, mPositionRows[r].bodyB);
 
-        // bias (Baumgarte) solo en velocidades
-        const float slop = penetrationSlop;
-        const float bias = -(beta / dt) * std::max(pen - slop, 0.f);
+    auto groupByIsland = [&](auto& rows, auto& scratch, const std::vector<uint32_t>& rowIsland, std::vector<uint32_t>& start)
+        {
+            start.assign((size_t)islandCount + 1, 0);
+            for (uint32_t isl : rowIsland) ++start[isl + 1];
+            for (uint32_t i = 0; i < islandCount; ++i) start[i + 1] += start[i];
 
-        float j = -((1.f + e) * velAlongN + bias) / denom;
-        if (j < 0.f) j = 0.f;
+            scratch.resize(rows.size());
+            mIslandCursor.assign(start.begin(), start.end() - 1);
+            for (size_t r = 0; r < rows.size(); ++r)
+                scratch[mIslandCursor[rowIsland[r]]++] = rows[r];
+            rows.swap(scratch);
+        };
 
-        const Vec2 impulse = n * j;
+    groupByIsland(mContactRows, mContactRowScratch, mRowIsland, mIslandRowStart);
+    groupByIsland(mPositionRows, mPositionRowScratch, mPositionIsland, mIslandPositionStart);
 
-        if (rbA && rbA->GetBodyType() == RigidBody2D::BodyType::Dynamic)
-        {
-            auto consA = rbA->GetConstraints();
+    nSolverIslands = (int)islandCount;
+}
 
-            Vec2 dv = impulse * invMA;
-            if ((consA & RigidBody2D::Constraints::FreezePosX) != RigidBody2D::Constraints::None) dv.x = 0.f;
-            if ((consA & RigidBody2D::Constraints::FreezePosY) != RigidBody2D::Constraints::None) dv.y = 0.f;
+void PhysicsManager::ApplyImpulse_(const ContactRow& row, float j) noexcept
+{
+    const Vec2 impulse = row.n * j;
 
-            vA -= dv;
+    SolverBody& A = mSolverBodies[row.bodyA];
+    SolverBody& B = mSolverBodies[row.bodyB];
 
-            if (invIA > 0.f) wA -= raCn * j * invIA;
-            else wA = 0.f;
+    if (A.invM > 0.f)
+    {
+        const Vec2 dv = impulse * A.invM;
+        A.v.x -= dv.x * A.linearMask.x;
+        A.v.y -= dv.y * A.linearMask.y;
 
-            rbA->SetVelocity(vA);
-            rbA->SetAngularVelocity(wA);
-        }
+        if (A.invI > 0.f) A.w -= row.rnA * j * A.invI;
+        else A.w = 0.f;
+    }
 
-        if (rbB && rbB->GetBodyType() == RigidBody2D::BodyType::Dynamic)
-        {
-            auto consB = rbB->GetConstraints();
+    if (B.invM > 0.f)
+    {
+        const Vec2 dv = impulse * B.invM;
+        B.v.x += dv.x * B.linearMask.x;
+        B.v.y += dv.y * B.linearMask.y;
 
-            Vec2 dv = impulse * invMB;
-            if ((consB & RigidBody2D::Constraints::FreezePosX) != RigidBody2D::Constraints::None) dv.x = 0.f;
-            if ((consB & RigidBody2D::Constraints::FreezePosY) != RigidBody2D::Constraints::None) dv.y = 0.f;
+        if (B.invI > 0.f) B.w += row.rnB * j * B.invI;
+        else B.w = 0.f;
+    }
+}
 
-            vB += dv;
+void PhysicsManager::WarmStart_(uint32_t begin, uint32_t end) noexcept
+{
+    for (uint32_t r = begin; r < end; ++r)
+        if (mContactRows[r].normalImpulse > 0.f) ApplyImpulse_(mContactRows[r], mContactRows[r].normalImpulse);
+}
 
-            if (invIB > 0.f) wB += rbCn * j * invIB;
-            else wB = 0.f;
+float PhysicsManager::SolveContacts_(uint32_t begin, uint32_t end) noexcept
+{
+    float maxDelta = 0.f;
 
-            rbB->SetVelocity(vB);
-            rbB->SetAngularVelocity(wB);
-        }
+    for (uint32_t r = begin; r < end; ++r)
+    {
+        ContactRow& row = mContactRows[r];
+
+        const SolverBody& A = mSolverBodies[row.bodyA];
+        const SolverBody& B = mSolverBodies[row.bodyB];
+
+        const Vec2 rv = (B.v + Perp(B.w, row.rB)) - (A.v + Perp(A.w, row.rA));
+        const float velAlongN = math::Dot(rv, row.n);
+
+        // Se clampa el acumulado, no el incremento: una iteracion puede devolver
+        // parte de lo que aplico otra (o el warm start) sin llegar a tirar de los cuerpos
+        float j = (row.bias + row.restitution - velAlongN) * row.normalMass;
+        const float acc = std::max(row.normalImpulse + j, 0.f);
+        j = acc - row.normalImpulse;
+        row.normalImpulse = acc;
+
+        if (j != 0.f) ApplyImpulse_(row, j);
+        maxDelta = std::max(maxDelta, std::abs(j));
     }
+
+    return maxDelta;
 }
 
-void PhysicsManager::PositionalCorrection_(const std::vector<NarrowContact>& contacts) noexcept
+int PhysicsManager::SolveIsland_(uint32_t island) noexcept
 {
-    // valores estables (no rebotan)
-    const float slop = penetrationSlop;      // normalmente 0
-    const float percent = penetrationPercent; // 0.15..0.30
+    const uint32_t begin = mIslandRowStart[island];
+    const uint32_t end = mIslandRowStart[island + 1];
 
-    for (const auto& c : contacts)
+    WarmStart_(begin, end);
+
+    // Al menos una iteracion; despues se corta en cuanto la isla converge
+    int iters = 0;
+    while (begin < end && iters < velocityIterations)
     {
-        if (!c.a || !c.b) continue;
-        if (c.isTriggerPair) continue;
+        ++iters;
+        if (SolveContacts_(begin, end) < solverTolerance) break;
+    }
 
-        auto* rbA = c.a->GetComponent<RigidBody2D>();
-        auto* rbB = c.b->GetComponent<RigidBody2D>();
-        if (!rbA && !rbB) continue;
+    PositionalCorrection_(mIslandPositionStart[island], mIslandPositionStart[island + 1]);
+    return iters;
+}
 
-        auto* trA = c.a->GetComponent<Transform>();
-        auto* trB = c.b->GetComponent<Transform>();
-        if (!trA || !trB) continue;
+void PhysicsManager::SolveIslands_() noexcept
+{
+    const uint32_t islands = (uint32_t)nSolverIslands;
+    const size_t rows = mContactRows.size() + mPositionRows.size();
 
-        Vec2 n = c.contact.normalA;
-        const float pen = c.contact.penetration;
+    JobSystem* jobs = JobSystem::GetInstancePtr_NO_ERROR_MSG();
+    const size_t threads = jobs ? jobs->GetThreadCount() : 1;
 
-        Vec3 pa3 = trA->position;
-        Vec3 pb3 = trB->position;
-        
-        const Vec2 centerA = (c.colA ? ColliderCenterWorld_(c.colA) : Vec2{ trA->position->x, trA->position->y });
-        const Vec2 centerB = (c.colB ? ColliderCenterWorld_(c.colB) : Vec2{ trB->position->x, trB->position->y });
+    size_t jobCount = (threads > 1) ? std::min({ threads * kSolverJobsPerThread, rows / kMinRowsPerSolverJob, (size_t)islands }) : 1;
+    if (jobCount < 1) jobCount = 1;
 
-        if (math::Dot(centerB - centerA, n) < 0.f) n = -n;
+    // Tramos de islas consecutivas con un numero de filas parecido
+    mSolverJobStart.assign(1, 0);
+    size_t acc = 0;
+    for (uint32_t i = 0; i < islands; ++i)
+    {
+        acc += (mIslandRowStart[i + 1] - mIslandRowStart[i]) + (mIslandPositionStart[i + 1] - mIslandPositionStart[i]);
+        if (acc * jobCount >= rows * mSolverJobStart.size() && mSolverJobStart.size() < jobCount)
+            mSolverJobStart.push_back(i + 1);
+    }
+    if (mSolverJobStart.back() != islands) mSolverJobStart.push_back(islands);
+    jobCount = mSolverJobStart.size() - 1;
+    nSolverJobs = (int)jobCount;
 
-        const float invMA = (rbA && rbA->GetBodyType() == RigidBody2D::BodyType::Dynamic) ? rbA->InvMass_() : 0.f;
-        const float invMB = (rbB && rbB->GetBodyType() == RigidBody2D::BodyType::Dynamic) ? rbB->InvMass_() : 0.f;
-        const float invMassSum = invMA + invMB;
-        if (invMassSum <= 0.f) continue;
+    mSolverJobIters.assign(std::max<size_t>(jobCount, 1), 0);
 
-        const float mag = std::max(pen - slop, 0.f) / invMassSum * percent;
+    auto runJob = [&](uint32_t j)
+        {
+            int iters = 0;
+            for (uint32_t i = mSolverJobStart[j]; i < mSolverJobStart[j + 1]; ++i)
+                iters = std::max(iters, SolveIsland_(i));
+            mSolverJobIters[j] = iters;
+        };
+
+    // Las islas no comparten cuerpos movibles: cada job escribe solo en los suyos
+    if (jobCount <= 1) { if (jobCount == 1) runJob(0); }
+    else jobs->ParallelFor((uint32_t)jobCount, runJob);
+
+    int iters = 0;
+    for (int it : mSolverJobIters) iters = std::max(iters, it);
+    solverIterations += iters;
+}
+
+void PhysicsManager::FinishContacts_() noexcept
+{
+    // Velocidades y correccion de posicion de vuelta a los cuerpos dinamicos
+    // (en el BodyStore: los Transform se escriben al final del paso fijo)
+    auto& bs = mWorld.bodies;
+    for (const SolverBody& sb : mSolverBodies)
+    {
+        if (sb.body == UINT32_MAX || sb.invM <= 0.f) continue;
+        bs.vx[sb.body] = sb.v.x;
+        bs.vy[sb.body] = sb.v.y;
+        bs.w[sb.body] = sb.w;
+        bs.px[sb.body] += sb.dp.x;
+        bs.py[sb.body] += sb.dp.y;
+    }
+
+    // Impulsos para el warm starting del siguiente paso
+    auto* collision = CollisionManager::GetInstancePtr();
+    if (!collision) return;
+
+    const uint32_t stamp = collision->mWorld.stamp;
+    for (const ContactRow& row : mContactRows)
+        if (row.pair) row.pair->StoreImpulse(stamp, row.colA, row.colB, row.id, row.normalImpulse);
+}
+
+void PhysicsManager::PositionalCorrection_(uint32_t begin, uint32_t end) noexcept
+{
+    // valores estables (no rebotan). Se acumula por cuerpo y se aplica en FinishContacts_
+    const float slop = penetrationSlop;      // normalmente 0
+    const float percent = penetrationPercent; // 0.15..0.30
+
+    for (uint32_t r = begin; r < end; ++r)
+    {
+        const PositionRow& row = mPositionRows[r];
+        SolverBody& A = mSolverBodies[row.bodyA];
+        SolverBody& B = mSolverBodies[row.bodyB];
+
+        const float invMassSum = A.invM + B.invM;
+        const float mag = std::max(row.penetration - slop, 0.f) / invMassSum * percent;
         if (mag <= 0.f) continue;
 
-        const Vec2 corr = n * mag;
+        const Vec2 corr = row.n * mag;
 
-        if (rbA && rbA->GetBodyType() == RigidBody2D::BodyType::Dynamic)
+        // Los inmoviles se comparten entre islas: no se escriben
+        if (A.invM > 0.f)
         {
-            auto consA = rbA->GetConstraints();
-            Vec2 delta = corr * invMA;
-            if ((consA & RigidBody2D::Constraints::FreezePosX) != RigidBody2D::Constraints::None) delta.x = 0.f;
-            if ((consA & RigidBody2D::Constraints::FreezePosY) != RigidBody2D::Constraints::None) delta.y = 0.f;
-
-            pa3.x -= delta.x;
-            pa3.y -= delta.y;
-            trA->position = pa3;
+            A.dp.x -= corr.x * A.invM * A.linearMask.x;
+            A.dp.y -= corr.y * A.invM * A.linearMask.y;
         }
-
-        if (rbB && rbB->GetBodyType() == RigidBody2D::BodyType::Dynamic)
+        if (B.invM > 0.f)
         {
-            auto consB = rbB->GetConstraints();
-            Vec2 delta = corr * invMB;
-            if ((consB & RigidBody2D::Constraints::FreezePosX) != RigidBody2D::Constraints::None) delta.x = 0.f;
-            if ((consB & RigidBody2D::Constraints::FreezePosY) != RigidBody2D::Constraints::None) delta.y = 0.f;
-
-            pb3.x += delta.x;
-            pb3.y += delta.y;
-            trB->position = pb3;
+            B.dp.x += corr.x * B.invM * B.linearMask.x;
+            B.dp.y += corr.y * B.invM * B.linearMask.y;
         }
     }
 }
 
 
+// Puede despertar a un dormido al tocarlo: dinamico despierto, cinematico con
+// velocidad o collider sin cuerpo (se mueve a mano, no se sabe si esta quieto)
+bool PhysicsManager::IsMoving_(const RigidBody2D* rb) noexcept
+{
+    if (!rb) return true;
+
+    switch (rb->GetBodyType())
+    {
+    case RigidBody2D::BodyType::Dynamic:
+        return !rb->IsSleeping();
+    case RigidBody2D::BodyType::Kinematic:
+        return math::LengthSq(rb->GetVelocity()) > 0.f || rb->GetAngularVelocity() != 0.f;
+    default:
+        return false;
+    }
+}
+
+uint32_t PhysicsManager::FindRoot_(std::vector<uint32_t>& parent, uint32_t i) noexcept
+{
+    while (parent[i] != i)
+    {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+void PhysicsManager::UpdateSleep_(float dt, const std::vector<NarrowContact>& contacts) noexcept
+{
+    nSleepingBodies = 0;
+    nIslands = 0;
+    if (!enableSleeping) return;
+
+    // 1) Dinamicos activos: indice de isla y tiempo quietos
+    const float linSq = sleepLinearVelocity * sleepLinearVelocity;
+
+    mIslandBodies.clear();
+    auto& bs = mWorld.bodies;
+    for (uint32_t i = 0; i < bs.Size(); ++i)
+    {
+        RigidBody2D* rb = bs.rb[i];
+        if (!bs.active[i]) continue;
+        if (rb->GetBodyType() != RigidBody2D::BodyType::Dynamic) continue;
+
+        rb->islandIndex_ = (uint32_t)mIslandBodies.size();
+        mIslandBodies.push_back(rb);
+
+        if (rb->IsSleeping()) continue;
+
+        const bool still = rb->allowSleep_ &&
+            math::LengthSq(rb->GetVelocity()) <= linSq &&
+            std::abs(rb->GetAngularVelocity()) <= sleepAngularVelocity;
+
+        rb->sleepTime_ = still ? rb->sleepTime_ + dt : 0.f;
+    }
+
+    const uint32_t n = (uint32_t)mIslandBodies.size();
+    mIslandParent.resize(n);
+    for (uint32_t i = 0; i < n; ++i) mIslandParent[i] = i;
+
+    // 2) Union por los contactos solidos del ultimo substep entre dos dinamicos
+    //    (estaticos y cinematicos no unen islas). Sin recorrer la tabla de pares.
+    auto inIsland = [&](const RigidBody2D* rb)
+        {
+            return rb && rb->islandIndex_ < n && mIslandBodies[rb->islandIndex_] == rb;
+        };
+    auto join = [&](uint32_t a, uint32_t b)
+        {
+            const uint32_t ra = FindRoot_(mIslandParent, a);
+            const uint32_t rb = FindRoot_(mIslandParent, b);
+            if (ra != rb) mIslandParent[ra] = rb;
+        };
+
+    for (const NarrowContact& c : contacts)
+        if (inIsland(c.bodyA) && inIsland(c.bodyB))
+            join(c.bodyA->islandIndex_, c.bodyB->islandIndex_);
+
+    // Los pares entre dormidos no se prueban: se unen por la isla con la que se
+    // durmieron (uno que se despierta con WakeUp() arrastra a los demas)
+    mSleepIslandFirst.clear();
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        const uint32_t id = bs.sleepIsland[mIslandBodies[i]->bodyIndex_];
+        if (id == 0) continue;
+        auto [it, inserted] = mSleepIslandFirst.try_emplace(id, i);
+        if (!inserted) join(i, it->second);
+    }
+
+    // 3) Por isla: el menor tiempo quieto, si queda alguien despierto, cuantos son
+    //    y el id con el que ya duerme (si alguno duerme)
+    mIslandMinSleep.assign(n, 1e30f);
+    mIslandAwake.assign(n, 0);
+    mIslandSize.assign(n, 0);
+    mIslandSleepId.assign(n, 0);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        const RigidBody2D* rb = mIslandBodies[i];
+        const uint32_t root = FindRoot_(mIslandParent, i);
+        mIslandMinSleep[root] = std::min(mIslandMinSleep[root], rb->sleepTime_);
+        if (!rb->IsSleeping()) mIslandAwake[root] = 1;
+        if (const uint32_t id = bs.sleepIsland[rb->bodyIndex_]) mIslandSleepId[root] = id;
+        if (++mIslandSize[root] == 2) ++nIslands;
+    }
+
+    // 4) Toda la isla quieta el tiempo pedido: se duerme. Alguien despierto y
+    //    sin llegar: se despierta entera (lo que tocaba a un dormido lo arrastra).
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        RigidBody2D* rb = mIslandBodies[i];
+        const uint32_t root = FindRoot_(mIslandParent, i);
+
+        if (mIslandMinSleep[root] >= timeToSleep) rb->Sleep();
+        else if (mIslandAwake[root]) rb->WakeUp();
+
+        uint32_t& id = mIslandSleepId[root];
+        if (rb->IsSleeping())
+        {
+            // Isla que se acaba de dormir: id nuevo (0 queda para despierto)
+            if (id == 0)
+            {
+                if (++mSleepIslandCounter == 0) ++mSleepIslandCounter;
+                id = mSleepIslandCounter;
+            }
+            ++nSleepingBodies;
+        }
+        bs.sleepIsland[rb->bodyIndex_] = rb->IsSleeping() ? id : 0;
+    }
+}
+
 void PhysicsManager::Step(float fixedDt) noexcept
 {
     auto* collision = CollisionManager::GetInstancePtr();
@@ -387,33 +1080,44 @@ void PhysicsManager::Step(float fixedDt) noexcept
     nContactsProcessedThisFrame = 0;
     nSubstepsThisFrame = 0;
     solverIterations = 0;
+    nSolverIslands = 0;
+    nSolverJobs = 0;
+    nCcdSweeps = 0;
+    nCcdHits = 0;
 
     const double tStep0 = NowSec_();
 
+    // Estado de los cuerpos a los arrays: una lectura de Transform por cuerpo y paso
+    GatherBodies_();
+    GatherContinuous_();
+
     const int substeps = ComputeSubsteps_(fixedDt);
     const float dt = fixedDt / (float)substeps;
 
     nSubstepsThisFrame = substeps;
 
     std::vector<NarrowContact> contacts;
+    std::vector<NarrowContact> triggers;    // solapes de trigger: no entran en el solver
     contacts.reserve(128);
 
-    constexpr int kSolverIters = 8;
-    solverIterations = kSolverIters;
-
     for (int i = 0; i < substeps; ++i)
     {
         {
             const double t0 = NowSec_();
+            for (CcdBody& cb : mCcdBodies)
+                cb.start = { mWorld.bodies.px[cb.body], mWorld.bodies.py[cb.body] };
+
             Integrate_(dt);
+            SweepContinuous_();
             const double t1 = NowSec_();
             integrateTimeSec += (t1 - t0);
         }
 
         contacts.clear();
+        triggers.clear();
         {
             const double t0 = NowSec_();
-            collision->BuildContacts_(contacts);
+            collision->BuildContacts_(contacts, triggers);
             const double t1 = NowSec_();
             buildContactsTimeSec += (t1 - t0);
         }
@@ -423,15 +1127,39 @@ void PhysicsManager::Step(float fixedDt) noexcept
 
         {
             const double t0 = NowSec_();
-            for (int it = 0; it < kSolverIters; ++it)
-                SolveContacts_(contacts, dt);
-
-            PositionalCorrection_(contacts);
+            PrepareContacts_(contacts, dt);
+            SolveIslands_();
+            FinishContacts_();
             const double t1 = NowSec_();
             solveTimeSec += (t1 - t0);
         }
     }
 
+    // Una escritura de Transform por cuerpo movido, no una por substep
+    WriteBackBodies_();
+
+    // Sueno por islas con el estado del final del paso
+    UpdateSleep_(fixedDt, contacts);
+
+    // ... y copia en el store, con lo que queda acumulado: SaveState solo lee arrays
+    auto& bs = mWorld.bodies;
+    for (uint32_t i = 0; i < bs.Size(); ++i)
+    {
+        const RigidBody2D* rb = bs.rb[i];
+        bs.sleeping[i] = rb->sleeping_ ? 1 : 0;
+        bs.sleepTime[i] = rb->sleepTime_;
+        bs.forceX[i] = rb->accumForce_.x;
+        bs.forceY[i] = rb->accumForce_.y;
+        bs.accelX[i] = rb->accumAccel_.x;
+        bs.accelY[i] = rb->accumAccel_.y;
+        bs.torque[i] = rb->accumTorque_;
+        bs.angularAccel[i] = rb->accumAngularAccel_;
+    }
+
+    // Los contactos del ultimo substep sirven para el dispatch de eventos:
+    // asi la deteccion corre exactamente una vez por substep
+    collision->SetStepContacts_(contacts, triggers);
+
     const double tStep1 = NowSec_();
     stepTimeSec = (tStep1 - tStep0);
 }
@@ -1,5 +1,6 @@
 #include "Rigidbody2D.h"
 #include "PhysicsManager.h"
+#include "CollisionManager.h"
 #include "GameObject.h"
 
 void RigidBody2D::Awake()
@@ -9,7 +10,9 @@ void RigidBody2D::Awake()
 
 void RigidBody2D::OnEnable()
 {
-    PhysicsManager::GetInstancePtr()->SetBodyActive(this, true);
+    PhysicsManager::GetInstancePtr()->SetBodyActive(this, !gameObject->streamedOut);
+    // Los colliders en Auto dependen del cuerpo: puede haber aparecido ahora
+    CollisionManager::GetInstancePtr()->RefreshColliders(gameObject);
 }
 
 void RigidBody2D::OnDisable()
@@ -17,6 +20,16 @@ void RigidBody2D::OnDisable()
     PhysicsManager::GetInstancePtr()->SetBodyActive(this, false);
 }
 
+void RigidBody2D::SetBodyType(BodyType t) noexcept
+{
+    if (bodyType_ == t) return;
+    bodyType_ = t;
+    WakeUp();
+    if (mGameObject)
+        if (auto* cm = CollisionManager::GetInstancePtr())
+            cm->RefreshColliders(mGameObject);
+}
+
 void RigidBody2D::OnDestroy()
 {
     PhysicsManager::GetInstancePtr()->RemoveBody(this);
@@ -25,7 +38,7 @@ void RigidBody2D::OnDestroy()
 void RigidBody2D::Register()
 {
     PhysicsManager::GetInstancePtr()->RegisterBody(this);
-    PhysicsManager::GetInstancePtr()->SetBodyActive(this, mEnabled && gameObject->activeInHierarchy);
+    PhysicsManager::GetInstancePtr()->SetBodyActive(this, mEnabled && gameObject->activeInHierarchy && !gameObject->streamedOut);
 }
 
 //std::unique_ptr<Component> RigidBody2D::Clone(GameObject* newOwner) const
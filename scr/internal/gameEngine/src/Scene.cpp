@@ -1,15 +1,24 @@
 #include "Scene.h"
 
 #include <algorithm>
+#include <cmath>
+#include <unordered_set>
 
 #include "WindowManager.h"
 #include "AssetManager.h"
 #include "RenderManager.h"
 #include "SoundManager.h"
 #include "CollisionManager.h"
+#include "PhysicsManager.h"
+#include "Collider2D.h"
+#include "RigidBody2D.h"
 #include "Camera2D.h"
 #include "Transform.h"
 #include "GameObject.h"
+#include "SceneSnapshot.h"
+#include "SceneManager.h"
+#include "TimeManager.h"
+
 
 Scene::Scene() noexcept
 {
@@ -73,6 +82,7 @@ GameObject* Scene::CreateObject(std::string name, GameObject* parent)
     mByName[raw->GetName()] = raw;
 
     mNew.push_back(raw);
+    PartitionTouch_(raw);
 
     return raw;
 }
@@ -110,6 +120,14 @@ void Scene::DestroyObject(EntityID id)
     mDestroyQueue.emplace_back(id);
 }
 
+// Con presupuesto de activacion, los objetos Normal no se inician en bloque:
+// se quedan en la cola de nuevos y ProcessNewObjects los reparte entre frames.
+bool Scene::DefersActivation_(const GameObject* go) const noexcept
+{
+    return SceneManager::GetInstance().HasActivationBudget_() &&
+        go->GetActivationPriority() == GameObject::ActivationPriority::Normal;
+}
+
 // ===== Ciclo de vida global =====
 void Scene::AwakeAll()
 {
@@ -119,7 +137,7 @@ void Scene::AwakeAll()
         if (e) list.push_back(e.get());
 
     for (auto* go : list)
-        if (go) go->Awake();
+        if (go && !DefersActivation_(go)) go->Awake();
 }
 
 void Scene::StartAll()
@@ -130,7 +148,7 @@ void Scene::StartAll()
         if (e) list.push_back(e.get());
 
     for (auto* go : list)
-        if (go) go->Start();
+        if (go && !DefersActivation_(go)) go->Start();
 }
 
 void Scene::OnEnableAll()
@@ -204,24 +222,44 @@ void Scene::Register()
 // ===== Bucle principal =====
 void Scene::FixedUpdate(float dt)
 {
+    // Antes de los FixedUpdate y del Step de fisica de este paso
+    if (mLodEnabled) UpdateSimulationLod_();
+
     std::vector<GameObject*> list;
     list.reserve(mEntities.size());
     for (auto& e : mEntities)
         if (e) list.push_back(e.get());
 
+    // Sin LOD mLodScale es siempre 1
     for (auto* go : list)
-        if (go) go->FixedUpdate(dt);
+        if (go && go->mLodScale > 0.f) go->FixedUpdate(dt * go->mLodScale);
+
+    mCoroutines.FixedUpdate();
 }
 
 void Scene::Update(float dt)
 {
+    if (mPartitionEnabled) UpdatePartition_(dt);
+
     std::vector<GameObject*> list;
     list.reserve(mEntities.size());
     for (auto& e : mEntities)
         if (e) list.push_back(e.get());
 
+    if (mLodEnabled) ++mLodFrame;
+
     for (auto* go : list)
-        if (go) go->Update(dt);
+    {
+        if (!go) continue;
+        if (!mLodEnabled) { go->Update(dt); continue; }
+
+        const float h = SimulationLodFrameDt_(go, dt);
+        go->mLodFrameTick = h > 0.f;
+        if (h > 0.f) go->Update(h);
+    }
+
+    // Corrutinas: timers vencidos y WaitUntil, tras los Update
+    mCoroutines.Update(dt);
 }
 
 void Scene::Render()
@@ -268,6 +306,17 @@ GameObject* Scene::Find(const std::string& name) noexcept
     return (it != mByName.end() ? it->second : nullptr);
 }
 
+// ===== Snapshot =====
+bool Scene::SaveSnapshot(const std::string& path) const noexcept
+{
+    return SceneSnapshot::SaveToFile(*this, path);
+}
+
+bool Scene::LoadSnapshot(const std::string& path) noexcept
+{
+    return SceneSnapshot::LoadFromFile(*this, path);
+}
+
 // ===== Destruccin diferida =====
 void Scene::FlushDestroyQueue()
 {
@@ -300,6 +349,7 @@ void Scene::FlushDestroyQueue()
 
     purgePtrList(mNew);
     purgePtrList(mUninitialized);   // si la cola se llamara diferente, ajustar la llamada a purgePtrList
+    purgePtrList(mPartitionPending);
 
     // 3) Borrado en mEntities (de atrs hacia delante, estable y O(n))
     for (int i = static_cast<int>(mEntities.size()) - 1; i >= 0; --i) {
@@ -310,6 +360,7 @@ void Scene::FlushDestroyQueue()
             continue;
 
         // 3.1) OnDestroy del objeto
+        if (go->mChunkSlot >= 0) PartitionRemove_(go);
         go->OnDestroy();
 
         // 3.2) Limpiar ndices
@@ -331,6 +382,16 @@ void Scene::ProcessNewObjects()
     for (auto* go : mNew) mUninitialized.push_back(go);
     mNew.clear();
 
+    // Presupuesto de activacion (0 = sin limite). Solo cuentan los objetos que
+    // todavia necesitan Awake/Start; el primero Normal siempre pasa para que la
+    // cola avance aunque un solo objeto supere el presupuesto.
+    const SceneManager& sm = SceneManager::GetInstance();
+    const bool budgeted = sm.HasActivationBudget_();
+    const float budgetMs = sm.activationBudgetMs;
+    const int budgetCount = sm.activationBudgetCount;
+    const double t0 = budgeted ? (double)TimeManager::GetInstance().timeSinceStart : 0.0;
+    int activated = 0;
+
     // vector temporal para los que an no estn activos
     std::vector<GameObject*> pending;
     pending.clear();
@@ -340,6 +401,22 @@ void Scene::ProcessNewObjects()
     {
         if (go == nullptr) continue;
 
+        const bool needsInit = !go->mAwoken || !go->mStarted;
+        if (budgeted && needsInit && activated > 0 &&
+            go->GetActivationPriority() == GameObject::ActivationPriority::Normal)
+        {
+            const double elapsedMs = ((double)TimeManager::GetInstance().timeSinceStart - t0) * 1000.0;
+            const bool outOfBudget =
+                (budgetCount > 0 && activated >= budgetCount) ||
+                (budgetMs > 0.f && elapsedMs >= (double)budgetMs);
+
+            if (outOfBudget)
+            {
+                pending.push_back(go);
+                continue;
+            }
+        }
+
         // Comprobar si est activo en jerarqua
         const bool activeInHierarchy =
             (go->Parent() != nullptr
@@ -352,6 +429,9 @@ void Scene::ProcessNewObjects()
             go->Awake();     // solo hace algo si an no lo est
             go->Start();     // idem
             go->OnEnable();  // propaga a componentes e hijos
+
+            if (needsInit && go->GetActivationPriority() == GameObject::ActivationPriority::Normal)
+                ++activated;
         }
         else
         {
@@ -363,3 +443,350 @@ void Scene::ProcessNewObjects()
     // Sustituir la cola por los pendientes
     mUninitialized.swap(pending);
 }
+
+// ===== Particion del mundo =====
+void Scene::EnableWorldPartition(float chunkSize, float activeRadius, float evictAfterSeconds) noexcept
+{
+    DisableWorldPartition();
+    if (chunkSize <= 0.f) return;
+
+    mPartitionEnabled = true;
+    mChunkSize = chunkSize;
+    mChunkRadius = (activeRadius > 0.f) ? activeRadius : 0.f;
+    mEvictAfter = (evictAfterSeconds > 0.f) ? evictAfterSeconds : 0.f;
+    mRangeMinX = mRangeMinY = 0;
+    mRangeMaxX = mRangeMaxY = -1;
+
+    mPartitionPending.reserve(mEntities.size());
+    for (auto& e : mEntities)
+        if (e && !e->mParent) mPartitionPending.push_back(e.get());
+}
+
+void Scene::DisableWorldPartition() noexcept
+{
+    if (!mPartitionEnabled) return;
+
+    // Todo vuelve a simularse; los chunks expulsados se recrean
+    for (auto& [key, chunk] : mChunks)
+    {
+        if (!chunk.active) SetChunkActive_(chunk, true);
+        for (GameObject* go : chunk.objects) go->mChunkSlot = -1;
+    }
+
+    mChunks.clear();
+    mPartitionPending.clear();
+    mPartitionEnabled = false;
+}
+
+uint64_t Scene::ChunkKeyOf_(const GameObject* go) const noexcept
+{
+    const Vec3 p = go->mTransform ? (Vec3)go->mTransform->position : Vec3{};
+    return ChunkKey_((int)std::floor(p.x / mChunkSize), (int)std::floor(p.y / mChunkSize));
+}
+
+bool Scene::ChunkInRange_(uint64_t key) const noexcept
+{
+    const int cx = (int)(uint32_t)(key >> 32);
+    const int cy = (int)(uint32_t)(key & 0xFFFFFFFFu);
+    return cx >= mRangeMinX && cx <= mRangeMaxX && cy >= mRangeMinY && cy <= mRangeMaxY;
+}
+
+void Scene::PartitionTouch_(GameObject* go) noexcept
+{
+    if (mPartitionEnabled && go) mPartitionPending.push_back(go);
+}
+
+void Scene::PartitionInsert_(GameObject* go, uint64_t key) noexcept
+{
+    auto [it, created] = mChunks.try_emplace(key);
+    Chunk& chunk = it->second;
+    if (created) chunk.active = ChunkInRange_(key);
+
+    go->mChunkKey = key;
+    go->mChunkSlot = (int32_t)chunk.objects.size();
+    chunk.objects.push_back(go);
+
+    if (go->mStreamedOut != !chunk.active) SetStreamedOut_(go, !chunk.active);
+}
+
+void Scene::PartitionRemove_(GameObject* go) noexcept
+{
+    auto it = mChunks.find(go->mChunkKey);
+    if (it != mChunks.end())
+    {
+        // swap-remove O(1)
+        auto& objs = it->second.objects;
+        const size_t slot = (size_t)go->mChunkSlot;
+        if (slot < objs.size() && objs[slot] == go)
+        {
+            objs[slot] = objs.back();
+            objs[slot]->mChunkSlot = (int32_t)slot;
+            objs.pop_back();
+        }
+    }
+    go->mChunkSlot = -1;
+}
+
+void Scene::SetStreamedOut_(GameObject* go, bool out) noexcept
+{
+    go->mStreamedOut = out;
+
+    auto* collision = CollisionManager::GetInstancePtr();
+    auto* physics = PhysicsManager::GetInstancePtr();
+    const bool live = !out && go->IsActiveInHierarchy();
+
+    for (auto& c : go->components)
+    {
+        if (auto* col = dynamic_cast<Collider2D*>(c.get()))
+            collision->SetColliderActive(col, live && col->enabled);
+        else if (auto* rb = dynamic_cast<RigidBody2D*>(c.get()))
+            physics->SetBodyActive(rb, live && rb->enabled);
+
+        // Las corrutinas que vencieron mientras estaba suspendido siguen ahora
+        if (!out)
+            if (auto* b = dynamic_cast<Behaviour*>(c.get())) mCoroutines.ResumeHeld(b);
+    }
+
+    for (auto* ch : go->mChildren)
+        if (ch) SetStreamedOut_(ch, out);
+}
+
+void Scene::SetChunkActive_(Chunk& chunk, bool active) noexcept
+{
+    chunk.active = active;
+    chunk.suspendedTime = 0.f;
+
+    for (GameObject* go : chunk.objects)
+        SetStreamedOut_(go, !active);
+
+    // Chunk expulsado: recrear sus objetos (se reparten en la siguiente actualizacion)
+    if (active && !chunk.evicted.empty())
+    {
+        std::vector<uint8_t> data;
+        data.swap(chunk.evicted);
+        SceneSnapshot::Read(*this, data.data(), data.size());
+    }
+}
+
+void Scene::EvictChunk_(Chunk& chunk) noexcept
+{
+    chunk.suspendedTime = 0.f;
+    if (!chunk.evicted.empty()) return;
+
+    if (!SceneSnapshot::WriteObjects(*this, chunk.objects, chunk.evicted))
+    {
+        chunk.evicted.clear();
+        return;
+    }
+
+    for (GameObject* go : chunk.objects)
+    {
+        go->mChunkSlot = -1;
+        DestroyObject(go->GetID());
+    }
+    chunk.objects.clear();
+}
+
+void Scene::UpdatePartition_(float dt) noexcept
+{
+    // 1) Objetos nuevos, reparentados o con el pin cambiado
+    for (GameObject* go : mPartitionPending)
+    {
+        const bool wantsChunk = !go->mParent && !go->mPinned;
+
+        if (!wantsChunk)
+        {
+            if (go->mChunkSlot >= 0) PartitionRemove_(go);
+            const bool out = (go->mParent && !go->mPinned) ? go->mParent->mStreamedOut : false;
+            if (go->mStreamedOut != out) SetStreamedOut_(go, out);
+        }
+        else if (go->mChunkSlot < 0)
+        {
+            PartitionInsert_(go, ChunkKeyOf_(go));
+        }
+    }
+    mPartitionPending.clear();
+
+    // 2) Rango activo: viewRect de la camara + radio, en coordenadas de chunk
+    if (mCamera)
+    {
+        const Rect v = mCamera->viewRect;
+        const float x0 = std::min(v.x, v.x + v.w) - mChunkRadius;
+        const float x1 = std::max(v.x, v.x + v.w) + mChunkRadius;
+        const float y0 = std::min(v.y, v.y + v.h) - mChunkRadius;
+        const float y1 = std::max(v.y, v.y + v.h) + mChunkRadius;
+
+        mRangeMinX = (int)std::floor(x0 / mChunkSize);
+        mRangeMaxX = (int)std::floor(x1 / mChunkSize);
+        mRangeMinY = (int)std::floor(y0 / mChunkSize);
+        mRangeMaxY = (int)std::floor(y1 / mChunkSize);
+    }
+
+    // 3) Solo se mueven objetos de chunks activos: re-agrupar los que cambiaron de chunk
+    std::vector<std::pair<GameObject*, uint64_t>> moved;
+    for (auto& [key, chunk] : mChunks)
+    {
+        if (!chunk.active) continue;
+        for (GameObject* go : chunk.objects)
+        {
+            const uint64_t k = ChunkKeyOf_(go);
+            if (k != key) moved.emplace_back(go, k);
+        }
+    }
+    for (auto& [go, key] : moved)
+    {
+        PartitionRemove_(go);
+        PartitionInsert_(go, key);
+    }
+
+    // 4) Activar / suspender por rango, expulsar los que llevan tiempo suspendidos
+    for (auto it = mChunks.begin(); it != mChunks.end(); )
+    {
+        Chunk& chunk = it->second;
+
+        const bool inRange = ChunkInRange_(it->first);
+        if (inRange != chunk.active) SetChunkActive_(chunk, inRange);
+
+        if (!chunk.active && mEvictAfter > 0.f && !chunk.objects.empty())
+        {
+            chunk.suspendedTime += dt;
+            if (chunk.suspendedTime >= mEvictAfter) EvictChunk_(chunk);
+        }
+
+        if (chunk.objects.empty() && chunk.evicted.empty()) it = mChunks.erase(it);
+        else ++it;
+    }
+}
+
+// ===== Nivel de detalle de la simulacion =====
+void Scene::EnableSimulationLod(float margin, int reducedInterval, float freezeDistance) noexcept
+{
+    DisableSimulationLod();
+
+    mLodEnabled = true;
+    mLodMargin = (margin > 0.f) ? margin : 0.f;
+    mLodInterval = (uint32_t)std::max(reducedInterval, 1);
+    mLodFreezeDistance = (freezeDistance > 0.f) ? std::max(freezeDistance, mLodMargin) : 0.f;
+    mLodStep = mLodFrame = 0;
+}
+
+void Scene::DisableSimulationLod() noexcept
+{
+    if (!mLodEnabled) return;
+
+    // Todo vuelve a ritmo completo; lo acumulado en Reduced se pierde
+    for (auto& e : mEntities)
+    {
+        if (!e) continue;
+        if (e->mLodTier == SimulationLod::Frozen) ResumeHeldCoroutines_(e.get());
+        e->mLodTier = SimulationLod::Full;
+        e->mLodFrameTick = true;
+        e->mLodScale = 1.f;
+        e->mLodPendingSteps = 0;
+        e->mLodPendingDt = 0.f;
+    }
+
+    mLodCounts[0] = mLodCounts[1] = mLodCounts[2] = 0;
+    mLodEnabled = false;
+}
+
+void Scene::UpdateSimulationLod_() noexcept
+{
+    ++mLodStep;
+    mLodCounts[0] = mLodCounts[1] = mLodCounts[2] = 0;
+
+    // Distancia de Chebyshev al viewRect (0 dentro), como el radio de la particion
+    float x0 = 0.f, x1 = 0.f, y0 = 0.f, y1 = 0.f;
+    if (mCamera)
+    {
+        const Rect v = mCamera->viewRect;
+        x0 = std::min(v.x, v.x + v.w);
+        x1 = std::max(v.x, v.x + v.w);
+        y0 = std::min(v.y, v.y + v.h);
+        y1 = std::max(v.y, v.y + v.h);
+    }
+
+    for (auto& e : mEntities)
+    {
+        GameObject* go = e.get();
+        if (!go || go->mParent) continue;
+
+        SimulationLod tier = SimulationLod::Full;
+        if (mCamera && go->mTransform)
+        {
+            const Vec3 p = go->mTransform->position;
+            const float d = std::max(std::max({ x0 - p.x, p.x - x1, 0.f }), std::max({ y0 - p.y, p.y - y1, 0.f }));
+
+            if (mLodFreezeDistance > 0.f && d > mLodFreezeDistance) tier = SimulationLod::Frozen;
+            else if (d > mLodMargin) tier = SimulationLod::Reduced;
+        }
+
+        ApplySimulationLod_(go, tier, go->id);
+    }
+}
+
+void Scene::ApplySimulationLod_(GameObject* go, SimulationLod tier, uint32_t phase) noexcept
+{
+    // Un pin cubre tambien a sus hijos
+    if (go->mLodPinned) tier = SimulationLod::Full;
+
+    const bool thawed = go->mLodTier == SimulationLod::Frozen && tier != SimulationLod::Frozen;
+    go->mLodTier = tier;
+    if (thawed) ResumeHeldCoroutines_(go);
+    go->mLodPhase = phase;
+    ++mLodCounts[(uint8_t)tier];
+
+    // Sin correr (inactivo, suspendido o sin Start) no se acumula tiempo
+    const bool running = go->IsActiveInHierarchy() && !go->mStreamedOut && go->mStarted;
+
+    switch (running ? tier : SimulationLod::Frozen)
+    {
+    case SimulationLod::Full:
+        go->mLodScale = (float)(go->mLodPendingSteps + 1);
+        go->mLodPendingSteps = 0;
+        break;
+    case SimulationLod::Reduced:
+        if ((mLodStep + phase) % mLodInterval == 0)
+        {
+            go->mLodScale = (float)(go->mLodPendingSteps + 1);
+            go->mLodPendingSteps = 0;
+        }
+        else
+        {
+            go->mLodScale = 0.f;
+            ++go->mLodPendingSteps;
+        }
+        break;
+    case SimulationLod::Frozen:
+        go->mLodScale = 0.f;
+        go->mLodPendingSteps = 0;
+        go->mLodPendingDt = 0.f;
+        break;
+    }
+
+    for (GameObject* ch : go->mChildren)
+        if (ch) ApplySimulationLod_(ch, tier, phase);
+}
+
+float Scene::SimulationLodFrameDt_(GameObject* go, float dt) noexcept
+{
+    if (go->mLodTier == SimulationLod::Frozen || !go->IsActiveInHierarchy() || go->mStreamedOut || !go->mStarted)
+    {
+        go->mLodPendingDt = 0.f;
+        return 0.f;
+    }
+
+    go->mLodPendingDt += dt;
+    if (go->mLodTier == SimulationLod::Reduced && (mLodFrame + go->mLodPhase) % mLodInterval != 0)
+        return 0.f;
+
+    const float h = go->mLodPendingDt;
+    go->mLodPendingDt = 0.f;
+    return h;
+}
+
+void Scene::ResumeHeldCoroutines_(GameObject* go) noexcept
+{
+    for (auto& c : go->components)
+        if (auto* b = dynamic_cast<Behaviour*>(c.get())) mCoroutines.ResumeHeld(b);
+}
@@ -7,8 +7,11 @@
 #include "PhysicsManager.h"
 #include "Scene.h"
 
-bool SceneManager::Init() noexcept
+bool SceneManager::Init(const Config& cfg) noexcept
 {
+    SetActivationBudgetMs(cfg.activationBudgetMs);
+    SetActivationBudgetCount(cfg.activationBudgetCount);
+
     mAssets = AssetManager::GetInstancePtr();
     mRender = RenderManager::GetInstancePtr();
     mSound = SoundManager::GetInstancePtr();
@@ -74,14 +77,26 @@ void SceneManager::Register(const std::string& id, SceneBuilder builder) noexcep
     mRegistry[id.empty() ? "unnamed_" + std::to_string(++mUnnamedCounter) : id] = Entry{std::move(builder), false, nullptr};
 }
 
+void SceneManager::RegisterSnapshot(const std::string& id, const std::string& path) noexcept
+{
+    Register(id, [path](Scene* scene) {
+        if (scene) scene->LoadSnapshot(path);
+        });
+}
+
 void SceneManager::SetPersistent(const std::string& id, bool persistent) noexcept
 {
     auto it = mRegistry.find(id);
     if (it == mRegistry.end()) return;
 
     it->second.persistent = persistent;
-    if (!persistent)
+    if (!persistent && it->second.instance)
+    {
+        // su mundo de colision/fisica aparcado ya no se va a reanudar
+        CollisionManager::GetInstancePtr()->DiscardWorld(it->second.instance.get());
+        PhysicsManager::GetInstancePtr()->DiscardWorld(it->second.instance.get());
         it->second.instance.reset(); // opcional: al desmarcar, reset
+    }
 }
 
 void SceneManager::ApplyPendingScene() noexcept
@@ -102,8 +117,18 @@ void SceneManager::ApplyPendingScene() noexcept
         mActive->OnDestroyAll();
     }
 
-    CollisionManager::GetInstancePtr()->ClearAll();
-    PhysicsManager::GetInstancePtr()->mBodies.clear();
+    // Mundo de colision/fisica: la escena persistente lo aparca tal cual (O(1)),
+    // cualquier otra lo descarta.
+    if (hadActive && activeWasPersistent)
+    {
+        CollisionManager::GetInstancePtr()->SuspendWorld(mActive.get());
+        PhysicsManager::GetInstancePtr()->SuspendWorld(mActive.get());
+    }
+    else
+    {
+        CollisionManager::GetInstancePtr()->ClearAll();
+        PhysicsManager::GetInstancePtr()->ClearAll();
+    }
 
     // Si la activa era persistente, devulvela al registry (para reusarla)
     if (!mActiveId.empty())
@@ -158,6 +183,15 @@ void SceneManager::ApplyPendingScene() noexcept
     mHasPending = false;
     mPendingSceneId.clear();
 
+    // Escena persistente ya arrancada: recupera su mundo aparcado antes de OnEnable
+    bool worldResumed = false;
+    if (mActive && mActive->mStarted)
+    {
+        const bool colResumed = CollisionManager::GetInstancePtr()->ResumeWorld(mActive.get());
+        const bool physResumed = PhysicsManager::GetInstancePtr()->ResumeWorld(mActive.get());
+        worldResumed = colResumed && physResumed;
+    }
+
     // --- 3) Arranque limpio ---
     if (mActive)
     {
@@ -169,8 +203,9 @@ void SceneManager::ApplyPendingScene() noexcept
             mActive->StartAll();
             mActive->mStarted = true;
         }
-        else
+        else if (!worldResumed)
         {
+            // Sin mundo aparcado (p.ej. escena pasada por SetActive(unique_ptr)): registro completo
             mActive->Register();
         }
     }
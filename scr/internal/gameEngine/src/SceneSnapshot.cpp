@@ -0,0 +1,690 @@
+#include "SceneSnapshot.h"
+
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+#include <type_traits>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Scene.h"
+#include "GameObject.h"
+#include "Transform.h"
+#include "SpriteRenderer.h"
+#include "Collider2D.h"
+#include "RigidBody2D.h"
+#include "Camera2D.h"
+#include "AssetManager.h"
+#include "ErrorHandler.h"
+
+// ===== Formato en disco =====
+namespace
+{
+    constexpr char     kMagic[4] = { 'X', 'S', 'C', 'N' };
+    constexpr uint32_t kVersion = 1;
+    constexpr uint32_t kEndianTag = 0x01020304u;
+    constexpr uint32_t kNoString = 0xFFFFFFFFu;
+
+    enum class BlockType : uint32_t
+    {
+        Entities = 1,
+        Transforms,
+        Sprites,
+        Colliders,
+        Bodies,
+        Behaviours,
+        Blob,           // datos propios de scripts (OnSnapshotSave)
+        Camera,
+    };
+
+    struct FileHeader
+    {
+        char     magic[4];
+        uint32_t version;
+        uint32_t endianTag;
+        uint32_t blockCount;
+        uint64_t stringTableOffset;
+        uint64_t stringTableSize;
+    };
+
+    struct BlockDesc
+    {
+        uint32_t type;
+        uint32_t count;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    struct EntityRecord
+    {
+        uint32_t name;
+        uint32_t tag;
+        int32_t  parent;     // indice en el bloque de entidades (-1 = raiz)
+        uint8_t  active;
+        uint8_t  pad[3];
+    };
+
+    struct TransformRecord
+    {
+        uint32_t entity;
+        float    pos[3];     // local
+        float    scale[2];   // local
+        float    rot[3];     // local (grados)
+    };
+
+    struct SpriteRecord
+    {
+        uint32_t entity;
+        uint32_t textureKey;
+        int32_t  src[4];
+        uint8_t  tint[4];
+        uint8_t  flipX, flipY, enabled, pad;
+        float    offset[2];
+        float    pivot01[2];
+    };
+
+    struct ColliderRecord
+    {
+        uint32_t entity;
+        uint8_t  shape, isTrigger, inheritRotation, drawCollider;
+        uint8_t  customColor, enabled, bodyClass, pad;
+        uint8_t  color[4];
+        uint32_t layer;
+        uint32_t mask;
+        float    size[2];
+        float    radius;
+        float    offset[2];
+        float    angleOffsetDeg;
+    };
+
+    struct BodyRecord
+    {
+        uint32_t entity;
+        uint8_t  bodyType, detection, constraints, enabled;
+        float    mass, inertia, gravityScale;
+        float    linearDamping, angularDamping, restitution;
+        float    velocity[2];
+        float    angularVelocity;
+    };
+
+    struct BehaviourRecord
+    {
+        uint32_t entity;
+        uint32_t typeName;
+        uint32_t dataOffset;  // dentro del bloque Blob
+        uint32_t dataSize;
+        uint8_t  enabled, pad[3];
+    };
+
+    struct CameraRecord
+    {
+        float center[2];
+        float zoom;
+    };
+
+    static_assert(std::is_trivially_copyable_v<EntityRecord>);
+    static_assert(std::is_trivially_copyable_v<SpriteRecord>);
+    static_assert(std::is_trivially_copyable_v<ColliderRecord>);
+    static_assert(std::is_trivially_copyable_v<BodyRecord>);
+
+    inline size_t Align8(size_t v) noexcept { return (v + 7u) & ~size_t(7u); }
+
+    // Tabla de strings deduplicada
+    struct StringTable
+    {
+        std::string data;
+        std::unordered_map<std::string, uint32_t> offsets;
+
+        uint32_t Add(const std::string& s)
+        {
+            auto it = offsets.find(s);
+            if (it != offsets.end()) return it->second;
+            const uint32_t off = (uint32_t)data.size();
+            data.append(s);
+            data.push_back('\0');
+            offsets.emplace(s, off);
+            return off;
+        }
+    };
+
+    // Fichero mapeado en memoria (solo lectura)
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile() { Close(); }
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool Open(const std::string& path) noexcept
+        {
+#ifdef _WIN32
+            mFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (mFile == INVALID_HANDLE_VALUE) return false;
+
+            LARGE_INTEGER sz{};
+            if (!GetFileSizeEx(mFile, &sz) || sz.QuadPart <= 0) return false;
+            mSize = (size_t)sz.QuadPart;
+
+            mMapping = CreateFileMappingA(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!mMapping) return false;
+
+            mData = (const uint8_t*)MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0);
+            return mData != nullptr;
+#else
+            mFd = open(path.c_str(), O_RDONLY);
+            if (mFd < 0) return false;
+
+            struct stat st {};
+            if (fstat(mFd, &st) != 0 || st.st_size <= 0) return false;
+            mSize = (size_t)st.st_size;
+
+            void* p = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, mFd, 0);
+            if (p == MAP_FAILED) return false;
+            mData = (const uint8_t*)p;
+            return true;
+#endif
+        }
+
+        void Close() noexcept
+        {
+#ifdef _WIN32
+            if (mData) UnmapViewOfFile(mData);
+            if (mMapping) CloseHandle(mMapping);
+            if (mFile != INVALID_HANDLE_VALUE) CloseHandle(mFile);
+            mMapping = nullptr;
+            mFile = INVALID_HANDLE_VALUE;
+#else
+            if (mData) munmap((void*)mData, mSize);
+            if (mFd >= 0) close(mFd);
+            mFd = -1;
+#endif
+            mData = nullptr;
+            mSize = 0;
+        }
+
+        const uint8_t* Data() const noexcept { return mData; }
+        size_t Size() const noexcept { return mSize; }
+
+    private:
+#ifdef _WIN32
+        HANDLE mFile = INVALID_HANDLE_VALUE;
+        HANDLE mMapping = nullptr;
+#else
+        int mFd = -1;
+#endif
+        const uint8_t* mData = nullptr;
+        size_t mSize = 0;
+    };
+}
+
+SceneSnapshot::Registry& SceneSnapshot::GetRegistry_() noexcept
+{
+    static Registry registry;
+    return registry;
+}
+
+// ===== Escritura =====
+bool SceneSnapshot::Write(const Scene& scene, std::vector<uint8_t>& out) noexcept
+{
+    std::vector<GameObject*> order;
+    order.reserve(scene.GetEntities().size());
+    for (auto& e : scene.GetEntities())
+        if (e) order.push_back(e.get());
+
+    return Write_(scene, order, true, out);
+}
+
+bool SceneSnapshot::WriteObjects(const Scene& scene, const std::vector<GameObject*>& roots, std::vector<uint8_t>& out) noexcept
+{
+    std::vector<GameObject*> order;
+    order.reserve(roots.size());
+
+    std::vector<GameObject*> stack(roots.rbegin(), roots.rend());
+    while (!stack.empty())
+    {
+        GameObject* go = stack.back();
+        stack.pop_back();
+        if (!go) continue;
+
+        order.push_back(go);
+        for (auto* ch : go->Children()) stack.push_back(ch);
+    }
+
+    return Write_(scene, order, false, out);
+}
+
+bool SceneSnapshot::Write_(const Scene& scene, const std::vector<GameObject*>& order, bool withCamera, std::vector<uint8_t>& out) noexcept
+{
+    out.clear();
+
+    // 1) Orden padre -> hijos (profundidad estable)
+    auto depthOf = [](GameObject* go) noexcept {
+        int d = 0;
+        for (GameObject* p = go->parent; p; p = p->parent) ++d;
+        return d;
+        };
+
+    std::vector<std::pair<int, GameObject*>> byDepth;
+    byDepth.reserve(order.size());
+    for (auto* go : order) byDepth.emplace_back(depthOf(go), go);
+    std::stable_sort(byDepth.begin(), byDepth.end(),
+        [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    std::unordered_map<const GameObject*, int32_t> indexOf;
+    indexOf.reserve(byDepth.size());
+    for (size_t i = 0; i < byDepth.size(); ++i)
+        indexOf[byDepth[i].second] = (int32_t)i;
+
+    // 2) Rellenar bloques
+    StringTable strings;
+    std::vector<EntityRecord>    entities;
+    std::vector<TransformRecord> transforms;
+    std::vector<SpriteRecord>    sprites;
+    std::vector<ColliderRecord>  colliders;
+    std::vector<BodyRecord>      bodies;
+    std::vector<BehaviourRecord> behaviours;
+    std::vector<uint8_t>         blob;
+
+    entities.reserve(byDepth.size());
+    transforms.reserve(byDepth.size());
+
+    const Registry& reg = GetRegistry_();
+    AssetManager* assets = AssetManager::GetInstancePtr();
+
+    for (size_t i = 0; i < byDepth.size(); ++i)
+    {
+        GameObject* go = byDepth[i].second;
+        const uint32_t ent = (uint32_t)i;
+
+        EntityRecord er{};
+        er.name = strings.Add(go->name);
+        er.tag = strings.Add(go->tag);
+        // Padre fuera del conjunto guardado (WriteObjects): se carga como raiz
+        auto itParent = indexOf.find(go->parent);
+        er.parent = (itParent != indexOf.end()) ? itParent->second : -1;
+        er.active = go->activeSelf ? 1 : 0;
+        entities.push_back(er);
+
+        if (Transform* t = go->transform)
+        {
+            const Vec3 p = t->localPosition;
+            const Vec2 s = t->localScale;
+            const Vec3 r = t->localRotation;
+            transforms.push_back({ ent, { p.x, p.y, p.z }, { s.x, s.y }, { r.x, r.y, r.z } });
+        }
+
+        for (Behaviour* b : go->GetComponents<Behaviour>())
+        {
+            if (auto* sr = dynamic_cast<SpriteRenderer*>(b))
+            {
+                SpriteRecord rec{};
+                rec.entity = ent;
+                const Texture* tex = sr->sprite;
+                const std::string key = (tex && assets) ? assets->FindTextureKey(tex) : std::string();
+                rec.textureKey = key.empty() ? kNoString : strings.Add(key);
+                const RectI src = sr->source;
+                rec.src[0] = src.x; rec.src[1] = src.y; rec.src[2] = src.w; rec.src[3] = src.h;
+                const Color c = sr->tint;
+                rec.tint[0] = c.r; rec.tint[1] = c.g; rec.tint[2] = c.b; rec.tint[3] = c.a;
+                rec.flipX = sr->flipX ? 1 : 0;
+                rec.flipY = sr->flipY ? 1 : 0;
+                rec.enabled = sr->enabled ? 1 : 0;
+                const Vec2 off = sr->offset;
+                const Vec2 piv = sr->pivot01;
+                rec.offset[0] = off.x; rec.offset[1] = off.y;
+                rec.pivot01[0] = piv.x; rec.pivot01[1] = piv.y;
+                sprites.push_back(rec);
+            }
+            else if (auto* col = dynamic_cast<Collider2D*>(b))
+            {
+                ColliderRecord rec{};
+                rec.entity = ent;
+                rec.shape = (uint8_t)col->shape_;
+                rec.isTrigger = col->isTrigger ? 1 : 0;
+                rec.inheritRotation = col->inheritRotation ? 1 : 0;
+                rec.drawCollider = col->showGizmo ? 1 : 0;
+                rec.customColor = col->CustomGizmoColor ? 1 : 0;
+                rec.enabled = col->enabled ? 1 : 0;
+                rec.bodyClass = (uint8_t)col->bodyClass_;
+                const Color c = col->gizmoColor;
+                rec.color[0] = c.r; rec.color[1] = c.g; rec.color[2] = c.b; rec.color[3] = c.a;
+                rec.layer = col->layer;
+                rec.mask = col->mask;
+                const Vec2 sz = col->size;
+                const Vec2 off = col->localOffset;
+                rec.size[0] = sz.x; rec.size[1] = sz.y;
+                rec.radius = col->radius;
+                rec.offset[0] = off.x; rec.offset[1] = off.y;
+                rec.angleOffsetDeg = col->rotationOffset;
+                colliders.push_back(rec);
+            }
+            else if (auto* rb = dynamic_cast<RigidBody2D*>(b))
+            {
+                BodyRecord rec{};
+                rec.entity = ent;
+                rec.bodyType = (uint8_t)rb->bodyType_;
+                rec.detection = (uint8_t)rb->collisionDetection_;
+                rec.constraints = (uint8_t)rb->constraints_;
+                rec.enabled = rb->enabled ? 1 : 0;
+                rec.mass = rb->mass;
+                rec.inertia = rb->inertia;
+                rec.gravityScale = rb->gravityScale;
+                rec.linearDamping = rb->linearDamping;
+                rec.angularDamping = rb->angularDamping;
+                rec.restitution = rb->restitution;
+                const Vec2 v = rb->velocity;
+                rec.velocity[0] = v.x; rec.velocity[1] = v.y;
+                rec.angularVelocity = rb->angularVelocity;
+                bodies.push_back(rec);
+            }
+            else
+            {
+                // Script de juego: solo si su tipo esta registrado
+                auto it = reg.names.find(std::type_index(typeid(*b)));
+                if (it == reg.names.end()) continue;
+
+                BehaviourRecord rec{};
+                rec.entity = ent;
+                rec.typeName = strings.Add(it->second);
+                rec.enabled = b->enabled ? 1 : 0;
+
+                const size_t before = blob.size();
+                b->OnSnapshotSave(blob);
+                rec.dataOffset = (uint32_t)before;
+                rec.dataSize = (uint32_t)(blob.size() - before);
+                blob.resize(Align8(blob.size()), 0);
+                behaviours.push_back(rec);
+            }
+        }
+    }
+
+    CameraRecord cam{};
+    if (Camera2D* c = scene.camera)
+    {
+        const Vec2 center = c->center;
+        cam.center[0] = center.x; cam.center[1] = center.y;
+        cam.zoom = c->zoom;
+    }
+
+    // 3) Volcado: header + tabla de bloques + bloques alineados + strings
+    struct Pending { BlockType type; uint32_t count; const void* data; size_t size; };
+    const Pending blocks[] = {
+        { BlockType::Entities,   (uint32_t)entities.size(),   entities.data(),   entities.size() * sizeof(EntityRecord) },
+        { BlockType::Transforms, (uint32_t)transforms.size(), transforms.data(), transforms.size() * sizeof(TransformRecord) },
+        { BlockType::Sprites,    (uint32_t)sprites.size(),    sprites.data(),    sprites.size() * sizeof(SpriteRecord) },
+        { BlockType::Colliders,  (uint32_t)colliders.size(),  colliders.data(),  colliders.size() * sizeof(ColliderRecord) },
+        { BlockType::Bodies,     (uint32_t)bodies.size(),     bodies.data(),     bodies.size() * sizeof(BodyRecord) },
+        { BlockType::Behaviours, (uint32_t)behaviours.size(), behaviours.data(), behaviours.size() * sizeof(BehaviourRecord) },
+        { BlockType::Blob,       (uint32_t)blob.size(),       blob.data(),       blob.size() },
+        { BlockType::Camera,     withCamera ? 1u : 0u,        &cam,              withCamera ? sizeof(CameraRecord) : 0 },
+    };
+    const uint32_t blockCount = (uint32_t)(sizeof(blocks) / sizeof(blocks[0]));
+
+    size_t cursor = Align8(sizeof(FileHeader) + blockCount * sizeof(BlockDesc));
+    std::vector<BlockDesc> descs(blockCount);
+    for (uint32_t i = 0; i < blockCount; ++i)
+    {
+        descs[i] = { (uint32_t)blocks[i].type, blocks[i].count, (uint64_t)cursor, (uint64_t)blocks[i].size };
+        cursor = Align8(cursor + blocks[i].size);
+    }
+
+    FileHeader hdr{};
+    std::memcpy(hdr.magic, kMagic, sizeof(kMagic));
+    hdr.version = kVersion;
+    hdr.endianTag = kEndianTag;
+    hdr.blockCount = blockCount;
+    hdr.stringTableOffset = cursor;
+    hdr.stringTableSize = strings.data.size();
+
+    out.assign(cursor + strings.data.size(), 0);
+    std::memcpy(out.data(), &hdr, sizeof(hdr));
+    std::memcpy(out.data() + sizeof(hdr), descs.data(), descs.size() * sizeof(BlockDesc));
+    for (uint32_t i = 0; i < blockCount; ++i)
+        if (blocks[i].size) std::memcpy(out.data() + descs[i].offset, blocks[i].data, blocks[i].size);
+    if (!strings.data.empty())
+        std::memcpy(out.data() + cursor, strings.data.data(), strings.data.size());
+
+    return true;
+}
+
+bool SceneSnapshot::SaveToFile(const Scene& scene, const std::string& path) noexcept
+{
+    std::vector<uint8_t> bytes;
+    if (!Write(scene, bytes)) return false;
+
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f)
+    {
+        LogError("SceneSnapshot error", "SaveToFile(): could not open '" + path + "' for writing.");
+        return false;
+    }
+    const size_t written = std::fwrite(bytes.data(), 1, bytes.size(), f);
+    std::fclose(f);
+
+    if (written != bytes.size())
+    {
+        LogError("SceneSnapshot error", "SaveToFile(): short write on '" + path + "'.");
+        return false;
+    }
+    return true;
+}
+
+// ===== Lectura =====
+bool SceneSnapshot::Read(Scene& scene, const uint8_t* data, size_t size) noexcept
+{
+    if (!data || size < sizeof(FileHeader))
+    {
+        LogError("SceneSnapshot error", "Read(): buffer too small.");
+        return false;
+    }
+
+    FileHeader hdr;
+    std::memcpy(&hdr, data, sizeof(hdr));
+    if (std::memcmp(hdr.magic, kMagic, sizeof(kMagic)) != 0 || hdr.endianTag != kEndianTag)
+    {
+        LogError("SceneSnapshot error", "Read(): not a scene snapshot (bad magic).");
+        return false;
+    }
+    if (hdr.version != kVersion)
+    {
+        LogError("SceneSnapshot error", "Read(): unsupported version " + std::to_string(hdr.version) + ".");
+        return false;
+    }
+    if (sizeof(FileHeader) + (size_t)hdr.blockCount * sizeof(BlockDesc) > size ||
+        hdr.stringTableOffset + hdr.stringTableSize > size)
+    {
+        LogError("SceneSnapshot error", "Read(): truncated file.");
+        return false;
+    }
+
+    // Cada offset valido acaba en un NUL dentro de la tabla si la tabla acaba en NUL
+    const char* strings = (const char*)(data + hdr.stringTableOffset);
+    if (hdr.stringTableSize != 0 && strings[hdr.stringTableSize - 1] != '\0')
+    {
+        LogError("SceneSnapshot error", "Read(): corrupt string table.");
+        return false;
+    }
+    auto str = [&](uint32_t off) -> const char* {
+        return (off == kNoString || off >= hdr.stringTableSize) ? "" : strings + off;
+        };
+
+    // Localizar bloques (vistas directas sobre el buffer mapeado)
+    const BlockDesc* descs = (const BlockDesc*)(data + sizeof(FileHeader));
+    auto block = [&](BlockType t, size_t recSize, uint32_t& count) -> const uint8_t* {
+        count = 0;
+        for (uint32_t i = 0; i < hdr.blockCount; ++i)
+        {
+            const BlockDesc& d = descs[i];
+            if (d.type != (uint32_t)t) continue;
+            if (d.offset + d.size > size || (recSize && d.size < (uint64_t)d.count * recSize)) return nullptr;
+            count = d.count;
+            return data + d.offset;
+        }
+        return nullptr;
+        };
+
+    uint32_t nEnt = 0, nTr = 0, nSpr = 0, nCol = 0, nBody = 0, nBeh = 0, nBlob = 0, nCam = 0;
+    const auto* ents = (const EntityRecord*)block(BlockType::Entities, sizeof(EntityRecord), nEnt);
+    const auto* trs = (const TransformRecord*)block(BlockType::Transforms, sizeof(TransformRecord), nTr);
+    const auto* sprs = (const SpriteRecord*)block(BlockType::Sprites, sizeof(SpriteRecord), nSpr);
+    const auto* cols = (const ColliderRecord*)block(BlockType::Colliders, sizeof(ColliderRecord), nCol);
+    const auto* bods = (const BodyRecord*)block(BlockType::Bodies, sizeof(BodyRecord), nBody);
+    const auto* behs = (const BehaviourRecord*)block(BlockType::Behaviours, sizeof(BehaviourRecord), nBeh);
+    const auto* blob = block(BlockType::Blob, 1, nBlob);
+    const auto* cam = (const CameraRecord*)block(BlockType::Camera, sizeof(CameraRecord), nCam);
+
+    if (!ents)
+    {
+        LogError("SceneSnapshot error", "Read(): missing or corrupt entity block.");
+        return false;
+    }
+
+    // 1) Entidades en bloque (padre siempre antes que hijo)
+    std::vector<GameObject*> objs(nEnt, nullptr);
+    scene.mEntities.reserve(scene.mEntities.size() + nEnt);
+    scene.mById.reserve(scene.mById.size() + nEnt);
+    scene.mNew.reserve(scene.mNew.size() + nEnt);
+
+    for (uint32_t i = 0; i < nEnt; ++i)
+    {
+        const EntityRecord& er = ents[i];
+        GameObject* parent = (er.parent >= 0 && (uint32_t)er.parent < i) ? objs[er.parent] : nullptr;
+
+        GameObject* go = scene.CreateObject(str(er.name), parent);
+        go->tag = std::string(str(er.tag));
+        if (!er.active) go->SetActive(false);
+        objs[i] = go;
+    }
+
+    auto owner = [&](uint32_t ent) -> GameObject* { return ent < nEnt ? objs[ent] : nullptr; };
+
+    // 2) Bloques por tipo de componente
+    for (uint32_t i = 0; i < nTr; ++i)
+    {
+        const TransformRecord& r = trs[i];
+        GameObject* go = owner(r.entity);
+        if (!go || !go->transform) continue;
+        Transform* t = go->transform;
+        t->localPosition = Vec3{ r.pos[0], r.pos[1], r.pos[2] };
+        t->localScale = Vec2{ r.scale[0], r.scale[1] };
+        t->localRotation = Vec3{ r.rot[0], r.rot[1], r.rot[2] };
+    }
+
+    AssetManager* assets = AssetManager::GetInstancePtr();
+    for (uint32_t i = 0; i < nSpr; ++i)
+    {
+        const SpriteRecord& r = sprs[i];
+        GameObject* go = owner(r.entity);
+        if (!go) continue;
+        auto* sr = go->AddComponent<SpriteRenderer>();
+        if (r.textureKey != kNoString && assets)
+            sr->sprite = assets->GetTextureByKey(str(r.textureKey));
+        sr->source = RectI{ r.src[0], r.src[1], r.src[2], r.src[3] };
+        sr->tint = Color{ r.tint[0], r.tint[1], r.tint[2], r.tint[3] };
+        sr->flipX = r.flipX != 0;
+        sr->flipY = r.flipY != 0;
+        sr->offset = Vec2{ r.offset[0], r.offset[1] };
+        sr->pivot01 = Vec2{ r.pivot01[0], r.pivot01[1] };
+        sr->enabled = r.enabled != 0;
+    }
+
+    for (uint32_t i = 0; i < nCol; ++i)
+    {
+        const ColliderRecord& r = cols[i];
+        GameObject* go = owner(r.entity);
+        if (!go) continue;
+        auto* col = go->AddComponent<Collider2D>();
+        col->shape = (Collider2D::Shape)r.shape;
+        col->isTrigger = r.isTrigger != 0;
+        col->inheritRotation = r.inheritRotation != 0;
+        col->showGizmo = r.drawCollider != 0;
+        if (r.customColor) col->gizmoColor = Color{ r.color[0], r.color[1], r.color[2], r.color[3] };
+        col->layer = r.layer;
+        col->mask = r.mask;
+        col->size = Vec2{ r.size[0], r.size[1] };
+        col->radius = r.radius;
+        col->localOffset = Vec2{ r.offset[0], r.offset[1] };
+        col->rotationOffset = r.angleOffsetDeg;
+        col->bodyClass = (Collider2D::BodyClass)r.bodyClass;
+        col->enabled = r.enabled != 0;
+    }
+
+    for (uint32_t i = 0; i < nBody; ++i)
+    {
+        const BodyRecord& r = bods[i];
+        GameObject* go = owner(r.entity);
+        if (!go) continue;
+        auto* rb = go->AddComponent<RigidBody2D>();
+        rb->bodyType = (RigidBody2D::BodyType)r.bodyType;
+        rb->collisionDetection = (RigidBody2D::CollisionDetection)r.detection;
+        rb->constraints = (RigidBody2D::Constraints)r.constraints;
+        rb->mass = r.mass;
+        rb->inertia = r.inertia;
+        rb->gravityScale = r.gravityScale;
+        rb->linearDamping = r.linearDamping;
+        rb->angularDamping = r.angularDamping;
+        rb->restitution = r.restitution;
+        rb->velocity = Vec2{ r.velocity[0], r.velocity[1] };
+        rb->angularVelocity = r.angularVelocity;
+        rb->enabled = r.enabled != 0;
+    }
+
+    const Registry& reg = GetRegistry_();
+    for (uint32_t i = 0; i < nBeh; ++i)
+    {
+        const BehaviourRecord& r = behs[i];
+        GameObject* go = owner(r.entity);
+        if (!go) continue;
+
+        auto it = reg.factories.find(str(r.typeName));
+        if (it == reg.factories.end())
+        {
+            LogError("SceneSnapshot warning",
+                std::string("Read(): behaviour type '") + str(r.typeName) + "' is not registered, skipped.");
+            continue;
+        }
+
+        Behaviour* b = it->second(*go);
+        if (!b) continue;
+        if (blob && r.dataSize && (uint64_t)r.dataOffset + r.dataSize <= nBlob)
+            b->OnSnapshotLoad(blob + r.dataOffset, r.dataSize);
+        b->enabled = r.enabled != 0;
+    }
+
+    if (cam && nCam > 0)
+    {
+        if (Camera2D* c = scene.camera)
+        {
+            c->center = Vec2{ cam->center[0], cam->center[1] };
+            c->zoom = cam->zoom;
+        }
+    }
+
+    return true;
+}
+
+bool SceneSnapshot::LoadFromFile(Scene& scene, const std::string& path) noexcept
+{
+    MappedFile file;
+    if (!file.Open(path))
+    {
+        LogError("SceneSnapshot error", "LoadFromFile(): could not map '" + path + "'.");
+        return false;
+    }
+    return Read(scene, file.Data(), file.Size());
+}
@@ -0,0 +1,81 @@
+#include "StaticBVH.h"
+
+#include <algorithm>
+
+static inline Rect Combine(const Rect& a, const Rect& b) noexcept
+{
+    const float l = std::min(a.Left(), b.Left());
+    const float t = std::min(a.Top(), b.Top());
+    const float r = std::max(a.Right(), b.Right());
+    const float btm = std::max(a.Bottom(), b.Bottom());
+    return { l, t, r - l, btm - t };
+}
+
+void StaticBVH::Clear() noexcept
+{
+    mNodes.clear();
+    mItems.clear();
+}
+
+void StaticBVH::Build(const std::vector<Rect>& boxes) noexcept
+{
+    Build(boxes.data(), boxes.size(), 0);
+}
+
+void StaticBVH::Build(const Rect* boxes, size_t count, uint32_t indexBase) noexcept
+{
+    Clear();
+    if (count == 0) return;
+
+    mItems.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+        mItems.push_back({ boxes[i], indexBase + (uint32_t)i });
+
+    // Un arbol binario con hojas de >= 1 item tiene como mucho 2n - 1 nodos
+    mNodes.reserve(2 * count);
+    Build_(0, (int32_t)mItems.size());
+}
+
+void StaticBVH::Build_(int32_t first, int32_t count) noexcept
+{
+    const int32_t id = (int32_t)mNodes.size();
+    mNodes.emplace_back();
+
+    Rect bounds = mItems[first].aabb;
+    for (int32_t i = 1; i < count; ++i)
+        bounds = Combine(bounds, mItems[first + i].aabb);
+    mNodes[id].aabb = bounds;
+
+    if (count <= kLeafSize)
+    {
+        mNodes[id].first = first;
+        mNodes[id].count = count;
+        mNodes[id].escape = id + 1;
+        return;
+    }
+
+    // Partir por la mediana de los centros en el eje mas largo
+    Rect centers = { mItems[first].aabb.x + mItems[first].aabb.w * 0.5f,
+                     mItems[first].aabb.y + mItems[first].aabb.h * 0.5f, 0.f, 0.f };
+    for (int32_t i = 1; i < count; ++i)
+    {
+        const Rect& b = mItems[first + i].aabb;
+        centers = Combine(centers, { b.x + b.w * 0.5f, b.y + b.h * 0.5f, 0.f, 0.f });
+    }
+    const bool splitX = centers.w >= centers.h;
+
+    const int32_t half = count / 2;
+    auto begin = mItems.begin() + first;
+    std::nth_element(begin, begin + half, begin + count,
+        [splitX](const Item& a, const Item& b)
+        {
+            return splitX ? (a.aabb.x + a.aabb.w * 0.5f) < (b.aabb.x + b.aabb.w * 0.5f)
+                          : (a.aabb.y + a.aabb.h * 0.5f) < (b.aabb.y + b.aabb.h * 0.5f);
+        });
+
+    Build_(first, half);                    // hijo izquierdo = id + 1
+    Build_(first + half, count - half);
+
+    // mNodes puede haber realojado: acceder por indice
+    mNodes[id].escape = (int32_t)mNodes.size();
+}
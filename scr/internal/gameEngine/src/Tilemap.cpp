@@ -0,0 +1,379 @@
+#include "Tilemap.h"
+
+#include <cmath>
+#include <algorithm>
+
+#include "ErrorHandler.h"
+#include "GameObject.h"
+#include "Transform.h"
+#include "Collider2D.h"
+#include "RenderManager.h"
+#include "Camera2D.h"
+#include "Scene.h"
+
+// =================== Rejilla ===================
+
+void Tilemap::Resize(int width, int height) noexcept
+{
+    if (width < 0 || height < 0)
+    {
+        LogError("Tilemap::Resize()", "Width and height must be >= 0.");
+        return;
+    }
+
+    width_ = width;
+    height_ = height;
+    tiles_.assign((size_t)width * (size_t)height, kEmpty);
+    ResetStrips_();
+}
+
+int32_t Tilemap::GetTile(int x, int y) const noexcept
+{
+    if (x < 0 || y < 0 || x >= width_ || y >= height_) return kEmpty;
+    return tiles_[(size_t)y * width_ + x];
+}
+
+void Tilemap::SetTile(int x, int y, int32_t id) noexcept
+{
+    if (x < 0 || y < 0 || x >= width_ || y >= height_) return;
+
+    int32_t& t = tiles_[(size_t)y * width_ + x];
+    if (t == id) return;
+
+    // Solo cambia la colision si cambia la solidez
+    const bool wasSolid = IsSolid_(x, y);
+    t = id;
+    if (IsSolid_(x, y) != wasSolid) MarkDirty_(y);
+}
+
+void Tilemap::Fill(int x, int y, int w, int h, int32_t id) noexcept
+{
+    const int x0 = std::max(x, 0), y0 = std::max(y, 0);
+    const int x1 = std::min(x + w, width_), y1 = std::min(y + h, height_);
+
+    for (int j = y0; j < y1; ++j)
+        for (int i = x0; i < x1; ++i)
+            SetTile(i, j, id);
+}
+
+void Tilemap::Clear() noexcept
+{
+    std::fill(tiles_.begin(), tiles_.end(), kEmpty);
+    MarkAllDirty_();
+}
+
+void Tilemap::SetTileSolid(int32_t id, bool solid) noexcept
+{
+    if (id < 0) return;
+
+    if ((size_t)id >= nonSolid_.size())
+    {
+        if (solid) return;
+        nonSolid_.resize((size_t)id + 1, 0);
+    }
+
+    const uint8_t v = solid ? 0 : 1;
+    if (nonSolid_[id] == v) return;
+    nonSolid_[id] = v;
+    MarkAllDirty_();
+}
+
+bool Tilemap::IsTileSolid(int32_t id) const noexcept
+{
+    if (id < 0) return false;
+    return (size_t)id >= nonSolid_.size() || nonSolid_[id] == 0;
+}
+
+bool Tilemap::IsSolid_(int x, int y) const noexcept
+{
+    return IsTileSolid(tiles_[(size_t)y * width_ + x]);
+}
+
+bool Tilemap::WorldToCell(Vec2 world, int& x, int& y) const noexcept
+{
+    if (!mGameObject) return false;
+
+    const Vec3 p = transform->position;
+    const Vec2 sc = transform->scale;
+    const float cw = tileSize_.x * sc.x, ch = tileSize_.y * sc.y;
+    if (cw == 0.f || ch == 0.f) return false;
+
+    x = (int)std::floor((world.x - p.x) / cw);
+    y = (int)std::floor((world.y - p.y) / ch);
+    return x >= 0 && y >= 0 && x < width_ && y < height_;
+}
+
+Vec2 Tilemap::CellToWorld(int x, int y) const noexcept
+{
+    if (!mGameObject) return Vec2::Zero();
+
+    const Vec3 p = transform->position;
+    const Vec2 sc = transform->scale;
+    return { p.x + (x + 0.5f) * tileSize_.x * sc.x, p.y + (y + 0.5f) * tileSize_.y * sc.y };
+}
+
+// =================== Ajustes ===================
+
+void Tilemap::SetTileSize(Vec2 s) noexcept
+{
+    if (s.x <= 0.f || s.y <= 0.f)
+    {
+        LogError("Tilemap::SetTileSize()", "Tile size must be > 0.");
+        return;
+    }
+    tileSize_ = s;
+    settingsDirty_ = true;
+}
+
+void Tilemap::SetCollision(bool c) noexcept
+{
+    if (collision_ == c) return;
+    collision_ = c;
+    if (collisionObject_) collisionObject_->SetActive(collision_ && mEnabled);
+}
+
+void Tilemap::SetLayer(LayerBits l) noexcept
+{
+    if (layer_ == l) return;
+    layer_ = l;
+    settingsDirty_ = true;
+}
+
+void Tilemap::SetMask(LayerBits m) noexcept
+{
+    if (mask_ == m) return;
+    mask_ = m;
+    settingsDirty_ = true;
+}
+
+void Tilemap::SetStripRows(int rows) noexcept
+{
+    rows = std::max(rows, 1);
+    if (stripRows_ == rows) return;
+    stripRows_ = rows;
+    ResetStrips_();
+}
+
+int Tilemap::GetColliderCount() const noexcept
+{
+    size_t n = 0;
+    for (const Strip& s : strips_) n += s.rects.size();
+    return (int)n;
+}
+
+// =================== Colision ===================
+
+void Tilemap::MarkDirty_(int y) noexcept
+{
+    const int s = y / stripRows_;
+    if (s < 0 || s >= (int)strips_.size()) return;
+    strips_[s].dirty = true;
+    anyDirty_ = true;
+}
+
+void Tilemap::MarkAllDirty_() noexcept
+{
+    for (Strip& s : strips_) s.dirty = true;
+    anyDirty_ = true;
+}
+
+void Tilemap::ResetStrips_() noexcept
+{
+    // Los colliders vuelven al pool; las franjas nuevas los reutilizan
+    for (Strip& s : strips_)
+    {
+        for (Collider2D* c : s.colliders)
+        {
+            c->enabled = false;
+            spare_.push_back(c);
+        }
+    }
+
+    strips_.assign((size_t)((height_ + stripRows_ - 1) / stripRows_), Strip{});
+    anyDirty_ = true;
+}
+
+void Tilemap::ApplyRect_(Collider2D* col, const RectI& r) const noexcept
+{
+    col->size = Vec2{ r.w * tileSize_.x, r.h * tileSize_.y };
+    col->localOffset = Vec2{ (r.x + r.w * 0.5f) * tileSize_.x, (r.y + r.h * 0.5f) * tileSize_.y };
+    col->layer = layer_;
+    col->mask = mask_;
+    col->bodyClass = Collider2D::BodyClass::Static;     // re-hornea con la forma nueva
+}
+
+void Tilemap::RebuildStrip_(int s) noexcept
+{
+    Strip& strip = strips_[s];
+    const int y0 = s * stripRows_;
+    const int y1 = std::min(y0 + stripRows_, height_);
+    const int rows = y1 - y0;
+
+    // Greedy: se alarga cada tile libre en X lo que se pueda y luego la tira entera en Y
+    usedScratch_.assign((size_t)width_ * rows, 0);
+    rectScratch_.clear();
+
+    for (int y = 0; y < rows; ++y)
+    {
+        for (int x = 0; x < width_; ++x)
+        {
+            if (usedScratch_[(size_t)y * width_ + x] || !IsSolid_(x, y0 + y)) continue;
+
+            int w = 1;
+            while (x + w < width_ && !usedScratch_[(size_t)y * width_ + x + w] && IsSolid_(x + w, y0 + y)) ++w;
+
+            int h = 1;
+            for (; y + h < rows; ++h)
+            {
+                bool full = true;
+                for (int i = x; i < x + w && full; ++i)
+                    full = !usedScratch_[(size_t)(y + h) * width_ + i] && IsSolid_(i, y0 + y + h);
+                if (!full) break;
+            }
+
+            for (int j = y; j < y + h; ++j)
+                std::fill_n(usedScratch_.begin() + (size_t)j * width_ + x, w, (uint8_t)1);
+
+            rectScratch_.push_back({ x, y0 + y, w, h });
+        }
+    }
+
+    // Reutiliza los colliders de la franja (solo se tocan los que cambian)
+    for (size_t i = 0; i < rectScratch_.size(); ++i)
+    {
+        const RectI& r = rectScratch_[i];
+
+        if (i < strip.colliders.size())
+        {
+            const RectI& old = strip.rects[i];
+            if (settingsDirty_ || old.x != r.x || old.y != r.y || old.w != r.w || old.h != r.h)
+                ApplyRect_(strip.colliders[i], r);
+            continue;
+        }
+
+        Collider2D* col = nullptr;
+        if (!spare_.empty())
+        {
+            col = spare_.back();
+            spare_.pop_back();
+        }
+        else
+        {
+            col = collisionObject_->AddComponent<Collider2D>();
+            col->shape = Collider2D::Shape::Box;
+            col->inheritRotation = false;
+        }
+
+        ApplyRect_(col, r);
+        col->enabled = true;
+        strip.colliders.push_back(col);
+    }
+
+    // Sobran: al pool
+    while (strip.colliders.size() > rectScratch_.size())
+    {
+        Collider2D* col = strip.colliders.back();
+        strip.colliders.pop_back();
+        col->enabled = false;
+        spare_.push_back(col);
+    }
+
+    strip.rects = rectScratch_;
+    strip.dirty = false;
+}
+
+void Tilemap::RebuildDirty_() noexcept
+{
+    if (!collisionObject_ || !collision_) return;
+    if (!anyDirty_ && !settingsDirty_) return;
+
+    collisionObject_->tag = mGameObject->tag.get();
+
+    for (int s = 0; s < (int)strips_.size(); ++s)
+        if (strips_[s].dirty || settingsDirty_) RebuildStrip_(s);
+
+    anyDirty_ = false;
+    settingsDirty_ = false;
+}
+
+void Tilemap::RebuildCollision() noexcept
+{
+    RebuildDirty_();
+}
+
+// =================== Ciclo ===================
+
+void Tilemap::Awake()
+{
+    // Hijo con los colliders: sigue al Transform del tilemap
+    Scene* scn = scene;
+    if (!scn) return;
+
+    collisionObject_ = scn->CreateObject(mGameObject->name.get() + "Collision");
+    collisionObject_->SetParent(mGameObject, false);
+    collisionObject_->activationPriority = mGameObject->activationPriority.get();
+    collisionObject_->tag = mGameObject->tag.get();
+}
+
+void Tilemap::OnEnable()
+{
+    if (collisionObject_) collisionObject_->SetActive(collision_);
+}
+
+void Tilemap::OnDisable()
+{
+    if (collisionObject_) collisionObject_->SetActive(false);
+}
+
+void Tilemap::FixedUpdate(float)
+{
+    // Antes del paso de fisica de este mismo paso fijo
+    RebuildDirty_();
+}
+
+void Tilemap::Update(float)
+{
+    RebuildDirty_();
+}
+
+void Tilemap::Render()
+{
+    if (!enabled || !mGameObject || !atlas_ || tiles_.empty()) return;
+
+    auto& rm = RenderManager::GetInstance();
+
+    const int texW = atlas_->Width(), texH = atlas_->Height();
+    const int tpw = (tilePixelSize_.x > 0) ? tilePixelSize_.x : texW;
+    const int tph = (tilePixelSize_.y > 0) ? tilePixelSize_.y : texH;
+    if (tpw <= 0 || tph <= 0) return;
+    const int columns = std::max(texW / tpw, 1);
+
+    const Vec3 p = transform->position;
+    const Vec2 sc = transform->scale;
+    const float cw = tileSize_.x * sc.x, ch = tileSize_.y * sc.y;
+    if (cw <= 0.f || ch <= 0.f) return;
+
+    // Solo las celdas dentro de la vista de la camara
+    int x0 = 0, y0 = 0, x1 = width_, y1 = height_;
+    if (rm.mActiveCam)
+    {
+        const Rect view = rm.mActiveCam->viewRect;
+        x0 = std::max(x0, (int)std::floor((view.x - p.x) / cw));
+        y0 = std::max(y0, (int)std::floor((view.y - p.y) / ch));
+        x1 = std::min(x1, (int)std::floor((view.x + view.w - p.x) / cw) + 1);
+        y1 = std::min(y1, (int)std::floor((view.y + view.h - p.y) / ch) + 1);
+    }
+
+    for (int y = y0; y < y1; ++y)
+    {
+        for (int x = x0; x < x1; ++x)
+        {
+            const int32_t id = tiles_[(size_t)y * width_ + x];
+            if (id < 0) continue;
+
+            const Rect dst{ p.x + x * cw, p.y + y * ch, cw, ch };
+            const Rect src{ (float)((id % columns) * tpw), (float)((id / columns) * tph), (float)tpw, (float)tph };
+            rm.DrawTexture(*atlas_, dst, &src, 0.f, { 0.5f, 0.5f }, tint_);
+        }
+    }
+}